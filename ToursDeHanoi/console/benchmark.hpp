@@ -0,0 +1,291 @@
+// benchmark.hpp — mode benchmark non interactif
+// Exemple :
+//   ./hanoi --bench --n 10-24 --methods rec,iter --mode vector
+//           --warmup 1 --reps 10 [--threads 8] --format csv --out results.csv
+#pragma once
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "perf_counters.hpp"
+
+// Timings of one run, split as in the interactive RESULTS block
+struct RunResult {
+    long long moves = 0;
+    double time_calc = 0;   // generation
+    double time_exec = 0;   // replay
+    double time_total = 0;  // total
+    size_t memory_bytes = 0;
+    unsigned threads = 1;
+    int pegs = 3;
+    std::string buffer = "-";     // materialized moves: vector | thp | hugetlb | 4k
+    bool valid = true;            // replay reached the solved state
+    long long error_index = -1;   // first illegal move, if any
+    std::string error;            // the run could not be done (row not kept)
+    PerfSample perf_calc, perf_exec;  // hardware counters per phase
+};
+
+struct BenchOptions {
+    std::vector<int> disks;
+    std::vector<int> methods;  // menu numbers (1 = recursive, ...)
+    std::vector<int> modes;    // menu numbers (1 = materialize, ...)
+    int warmup = 1;
+    int reps = 5;
+    unsigned threads = 0;          // 0 = all hardware threads
+    int pegs = 4;                  // Frame-Stewart method only
+    std::string buffer = "vector"; // vector | thp | hugetlb (mode vector only)
+    std::string format = "table";  // table | csv | json
+    std::string out;               // empty = stdout
+};
+
+struct Stats {
+    double min = 0, median = 0, p99 = 0, mean = 0;
+};
+
+inline Stats compute_stats(std::vector<double> v) {
+    Stats s;
+    if (v.empty()) return s;
+    std::sort(v.begin(), v.end());
+    s.min = v.front();
+    s.median = v.size() % 2 ? v[v.size() / 2] : (v[v.size() / 2 - 1] + v[v.size() / 2]) / 2;
+    // nearest-rank percentile
+    size_t rank = (size_t)((99 * v.size() + 99) / 100);
+    s.p99 = v[std::min(v.size(), std::max<size_t>(rank, 1)) - 1];
+    double sum = 0;
+    for (double x : v) sum += x;
+    s.mean = sum / v.size();
+    return s;
+}
+
+// Splits "a,b,c" into words
+inline std::vector<std::string> split_list(const std::string &s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+// "10-24", "10-24:2" (with step) or "8,12,16"
+inline bool parse_disks(const std::string &s, std::vector<int> &out) {
+    for (const std::string &part : split_list(s)) {
+        int a, b, step = 1;
+        char dash, colon;
+        std::istringstream in(part);
+        if (!(in >> a)) return false;
+        if (in >> dash) {
+            if (dash != '-' || !(in >> b)) return false;
+            if (in >> colon && (colon != ':' || !(in >> step) || step <= 0)) return false;
+            for (int n = a; n <= b; n += step) out.push_back(n);
+        } else {
+            out.push_back(a);
+        }
+    }
+    return !out.empty();
+}
+
+inline int index_of(const std::vector<std::string> &names, const std::string &s) {
+    for (size_t i = 0; i < names.size(); i++) if (names[i] == s) return (int)i + 1;
+    return 0;
+}
+
+// Parses argv after "--bench"; prints the problem and returns false on error
+inline bool parse_bench_args(int argc, char **argv, const std::vector<std::string> &method_keys,
+                             const std::vector<std::string> &mode_keys, BenchOptions &opt) {
+    std::string disks = "10-20", methods = "rec,iter", modes = "vector";
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto value = [&](std::string &dst) {
+            if (i + 1 >= argc) return false;
+            dst = argv[++i];
+            return true;
+        };
+        std::string v;
+        bool ok = true;
+        if (a == "--bench") continue;
+        else if (a == "--n") ok = value(disks);
+        else if (a == "--methods") ok = value(methods);
+        else if (a == "--mode" || a == "--modes") ok = value(modes);
+        else if (a == "--warmup") { ok = value(v); opt.warmup = std::atoi(v.c_str()); }
+        else if (a == "--reps") { ok = value(v); opt.reps = std::atoi(v.c_str()); }
+        else if (a == "--threads") { ok = value(v); opt.threads = (unsigned)std::atoi(v.c_str()); }
+        else if (a == "--pegs") { ok = value(v); opt.pegs = std::atoi(v.c_str()); }
+        else if (a == "--buffer") ok = value(opt.buffer);
+        else if (a == "--format") ok = value(opt.format);
+        else if (a == "--out") ok = value(opt.out);
+        else { std::cerr << "Unknown option: " << a << "\n"; return false; }
+        if (!ok) { std::cerr << "Missing value for " << a << "\n"; return false; }
+    }
+    if (!parse_disks(disks, opt.disks)) { std::cerr << "Invalid --n: " << disks << "\n"; return false; }
+    for (int n : opt.disks) {
+        if (n < 0) { std::cerr << "--n values must be positive\n"; return false; }
+    }
+    for (const std::string &m : split_list(methods)) {
+        int id = index_of(method_keys, m);
+        if (!id) { std::cerr << "Unknown method: " << m << "\n"; return false; }
+        opt.methods.push_back(id);
+    }
+    for (const std::string &m : split_list(modes)) {
+        int id = index_of(mode_keys, m);
+        if (!id) { std::cerr << "Unknown mode: " << m << "\n"; return false; }
+        opt.modes.push_back(id);
+    }
+    if (opt.reps < 1 || opt.warmup < 0) { std::cerr << "Invalid --reps/--warmup\n"; return false; }
+    if (opt.buffer != "vector" && opt.buffer != "thp" && opt.buffer != "hugetlb") {
+        std::cerr << "Unknown buffer: " << opt.buffer << "\n";
+        return false;
+    }
+    if (opt.format != "table" && opt.format != "csv" && opt.format != "json") {
+        std::cerr << "Unknown format: " << opt.format << "\n";
+        return false;
+    }
+    return true;
+}
+
+struct BenchRow {
+    std::string method, mode;
+    int n;
+    long long moves;
+    unsigned threads;
+    int pegs;
+    std::string buffer;
+    size_t memory_bytes;
+    bool valid;
+    Stats calc, exec, total;
+    PerfSample perf_calc, perf_exec;  // last repetition
+};
+
+inline void write_bench_rows(std::ostream &os, const std::string &format, const std::vector<BenchRow> &rows) {
+    const char *phases[] = {"generation", "replay", "total"};
+    if (format == "csv") {
+        os << "method,mode,n,pegs,moves,threads,buffer,memory_bytes,valid,phase,min_s,median_s,p99_s,mean_s,moves_per_s";
+        for (const char *e : perf_event_names) os << ',' << e;
+        os << ",ipc,allocations\n";
+        for (const BenchRow &r : rows) {
+            const Stats *st[] = {&r.calc, &r.exec, &r.total};
+            const PerfSample *pf[] = {&r.perf_calc, &r.perf_exec, nullptr};
+            for (int p = 0; p < 3; p++) {
+                double rate = st[p]->median > 0 ? r.moves / st[p]->median : 0;
+                os << r.method << ',' << r.mode << ',' << r.n << ',' << r.pegs << ',' << r.moves << ',' << r.threads << ','
+                   << r.buffer << ',' << r.memory_bytes << ',' << (r.valid ? 1 : 0) << ',' << phases[p] << ',' << st[p]->min << ',' << st[p]->median << ','
+                   << st[p]->p99 << ',' << st[p]->mean << ',' << rate;
+                // empty cells: counter unavailable, or no counters for the total
+                for (int e = 0; e < PERF_EVENTS; e++) {
+                    os << ',';
+                    if (pf[p] && pf[p]->value[e] >= 0) os << pf[p]->value[e];
+                }
+                os << ',';
+                if (pf[p] && pf[p]->ipc() >= 0) os << pf[p]->ipc();
+                os << ',';
+                if (pf[p]) os << pf[p]->allocations;
+                os << '\n';
+            }
+        }
+    } else if (format == "json") {
+        os << "[\n";
+        for (size_t i = 0; i < rows.size(); i++) {
+            const BenchRow &r = rows[i];
+            const Stats *st[] = {&r.calc, &r.exec, &r.total};
+            os << "  {\"method\": \"" << r.method << "\", \"mode\": \"" << r.mode << "\", \"n\": " << r.n
+               << ", \"pegs\": " << r.pegs << ", \"moves\": " << r.moves << ", \"threads\": " << r.threads
+               << ", \"buffer\": \"" << r.buffer << "\", \"memory_bytes\": " << r.memory_bytes << ", \"valid\": " << (r.valid ? "true" : "false");
+            const PerfSample *pf[] = {&r.perf_calc, &r.perf_exec, nullptr};
+            for (int p = 0; p < 3; p++) {
+                double rate = st[p]->median > 0 ? r.moves / st[p]->median : 0;
+                os << ", \"" << phases[p] << "\": {\"min\": " << st[p]->min << ", \"median\": " << st[p]->median
+                   << ", \"p99\": " << st[p]->p99 << ", \"mean\": " << st[p]->mean
+                   << ", \"moves_per_s\": " << rate;
+                if (pf[p]) {
+                    os << ", \"counters\": {";
+                    for (int e = 0; e < PERF_EVENTS; e++) {
+                        os << '"' << perf_event_names[e] << "\": ";
+                        if (pf[p]->value[e] >= 0) os << pf[p]->value[e];
+                        else os << "null";
+                        os << ", ";
+                    }
+                    os << "\"allocations\": " << pf[p]->allocations << "}";
+                }
+                os << "}";
+            }
+            os << "}" << (i + 1 < rows.size() ? "," : "") << "\n";
+        }
+        os << "]\n";
+    } else {
+        for (const BenchRow &r : rows) {
+            os << r.method << " / " << r.mode << "  n=" << r.n << "  pegs=" << r.pegs << "  moves=" << r.moves
+               << (r.buffer != "-" ? "  buffer=" + r.buffer : std::string()) << (r.valid ? "" : "  INVALID") << "\n";
+            const Stats *st[] = {&r.calc, &r.exec, &r.total};
+            for (int p = 0; p < 3; p++) {
+                double rate = st[p]->median > 0 ? r.moves / st[p]->median : 0;
+                os << "  " << phases[p] << ": min " << st[p]->min << " s, median " << st[p]->median
+                   << " s, p99 " << st[p]->p99 << " s, " << rate / 1e6 << " Mmoves/s\n";
+            }
+            const PerfSample *pf[] = {&r.perf_calc, &r.perf_exec};
+            for (int p = 0; p < 2; p++) {
+                os << "  " << phases[p] << " counters:";
+                if (pf[p]->ipc() >= 0) os << " IPC " << pf[p]->ipc() << ",";
+                for (int e = PERF_BRANCH_MISSES; e < PERF_EVENTS; e++) {
+                    if (pf[p]->value[e] >= 0) os << " " << perf_event_names[e] << " " << pf[p]->value[e] << ",";
+                }
+                os << " allocations " << pf[p]->allocations << "\n";
+            }
+        }
+    }
+}
+
+// Sweeps methods x modes x disks. unsupported(method, mode, n) returns an
+// explanation (or nullptr); such combinations are reported and skipped.
+// Exit code 1 if any row is invalid or failed, or the output cannot be written.
+inline int run_benchmark(const BenchOptions &opt, const std::vector<std::string> &method_keys,
+                         const std::vector<std::string> &mode_keys,
+                         const std::function<const char *(int, int, int)> &unsupported,
+                         const std::function<RunResult(int, int, int)> &run) {
+    std::vector<BenchRow> rows;
+    bool all_valid = true;
+    for (int method : opt.methods) {
+        for (int mode : opt.modes) {
+            for (int n : opt.disks) {
+                if (const char *why = unsupported(method, mode, n)) {
+                    std::cerr << "skipped: " << method_keys[method - 1] << " " << mode_keys[mode - 1] << " n=" << n
+                              << " (" << why << ")\n";
+                    continue;
+                }
+                RunResult r;
+                for (int w = 0; w < opt.warmup && r.error.empty(); w++) r = run(method, mode, n);
+                std::vector<double> calc, exec, total;
+                bool valid = true;
+                for (int i = 0; i < opt.reps && r.error.empty(); i++) {
+                    r = run(method, mode, n);
+                    valid = valid && r.valid;
+                    calc.push_back(r.time_calc);
+                    exec.push_back(r.time_exec);
+                    total.push_back(r.time_total);
+                }
+                if (!r.error.empty()) {
+                    std::cerr << "FAILED: " << method_keys[method - 1] << " " << mode_keys[mode - 1] << " n=" << n << " ("
+                              << r.error << ")\n";
+                    all_valid = false;
+                    continue;
+                }
+                all_valid = all_valid && valid;
+                if (!valid) std::cerr << "INVALID: " << method_keys[method - 1] << " " << mode_keys[mode - 1] << " n=" << n << "\n";
+                rows.push_back({method_keys[method - 1], mode_keys[mode - 1], n, r.moves, r.threads, r.pegs,
+                                r.buffer, r.memory_bytes, valid, compute_stats(calc), compute_stats(exec), compute_stats(total),
+                                r.perf_calc, r.perf_exec});
+                std::cerr << "done: " << rows.back().method << " " << rows.back().mode << " n=" << n << "\n";
+            }
+        }
+    }
+    if (opt.out.empty()) {
+        write_bench_rows(std::cout, opt.format, rows);
+    } else {
+        std::ofstream f(opt.out);
+        if (!f) { std::cerr << "Cannot write " << opt.out << "\n"; return 1; }
+        write_bench_rows(f, opt.format, rows);
+    }
+    return all_valid ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+// big_stream.hpp — flux de mouvements pour n jusqu'à 127 disques
+// Compteur de mouvements sur 128 bits, état des piquets en masques de bits
+// (bit d = disque d+1), reprise sur point de contrôle et découpage en
+// intervalles [from, to] indépendants (un par processus).
+// Exemple :
+//   ./hanoi --big --n 80 --from 1 --to 1000000000000 --checkpoint part1.ckpt --every 60
+//   ./hanoi --big --resume part1.ckpt --checkpoint part1.ckpt
+#pragma once
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "hanoi_stream.hpp"
+
+using u128 = unsigned __int128;
+
+const int MAX_BIG_DISKS = 127;
+
+inline int ctz128(u128 x) {
+    uint64_t lo = (uint64_t)x;
+    return lo ? __builtin_ctzll(lo) : 64 + __builtin_ctzll((uint64_t)(x >> 64));
+}
+
+inline std::string u128_to_string(u128 x) {
+    if (x == 0) return "0";
+    std::string s;
+    while (x) { s.insert(s.begin(), char('0' + (int)(x % 10))); x /= 10; }
+    return s;
+}
+
+inline bool parse_u128(const std::string &s, u128 &out) {
+    if (s.empty()) return false;
+    u128 v = 0;
+    for (char c : s) {
+        if (c < '0' || c > '9') return false;
+        u128 next = v * 10 + (c - '0');
+        if (next / 10 != v) return false;  // overflow
+        v = next;
+    }
+    out = v;
+    return true;
+}
+
+inline u128 total_moves_u128(int n) { return ((u128)1 << n) - 1; }
+
+class BigMoveStream {
+public:
+    // Streams moves first..last (1-based, inclusive) of the n-disk solution
+    BigMoveStream(int n, u128 first, u128 last) : n(n), k(first - 1), last(last), failed(false) {
+        seek(first - 1);
+    }
+
+    // Peg state after k moves, straight from the bits of k: disk d+1 has
+    // moved ((k >> d) + 1) >> 1 times, always in the same cyclic direction.
+    void seek(u128 moves_done) {
+        k = moves_done;
+        pegs[0] = pegs[1] = pegs[2] = 0;
+        for (int d = 0; d < n; d++) {
+            u128 count = ((k >> d) + 1) >> 1;
+            int peg = (int)((count % 3) * direction(d) % 3);
+            pegs[peg] |= (u128)1 << d;
+        }
+    }
+
+    bool next(Move &m) {
+        if (failed || k >= last) return false;
+        ++k;
+        int d = ctz128(k);
+        u128 bit = (u128)1 << d;
+        int from = (pegs[0] & bit) ? 0 : ((pegs[1] & bit) ? 1 : 2);
+        int to = (from + direction(d)) % 3;
+        // legality: d must be the top of `from` and smaller than the top of `to`
+        if ((pegs[from] & (bit - 1)) || (pegs[to] & ((bit << 1) - 1))) {
+            failed = true;
+            return false;
+        }
+        pegs[from] ^= bit;
+        pegs[to] |= bit;
+        m = {char('A' + from), char('A' + to)};
+        return true;
+    }
+
+    int disks() const { return n; }
+    u128 moves_done() const { return k; }
+    u128 last_move() const { return last; }
+    bool done() const { return k >= last; }
+    bool illegal_move() const { return failed; }
+    bool solved() const { return pegs[0] == 0 && pegs[1] == 0 && pegs[2] == total_moves_u128(n); }
+
+    // "ABC..." : peg of disk 1, disk 2, ...
+    std::string peg_string() const {
+        std::string s(n, 'A');
+        for (int d = 0; d < n; d++) s[d] = (pegs[1] >> d) & 1 ? 'B' : ((pegs[2] >> d) & 1 ? 'C' : 'A');
+        return s;
+    }
+
+    // Written to path.tmp, synced, then renamed over path and the directory
+    // synced: after a crash path holds either the old or the new checkpoint
+    bool save_checkpoint(const std::string &path) const {
+        std::ostringstream text;
+        text << "hanoi-checkpoint 1\n"
+             << "n " << n << "\n"
+             << "done " << u128_to_string(k) << "\n"
+             << "last " << u128_to_string(last) << "\n"
+             << "pegs " << peg_string() << "\n";
+        std::string data = text.str(), tmp = path + ".tmp";
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        bool ok = ::write(fd, data.data(), data.size()) == (ssize_t)data.size() && ::fsync(fd) == 0;
+        ok = ::close(fd) == 0 && ok;
+        if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+            ::unlink(tmp.c_str());
+            return false;
+        }
+        size_t slash = path.rfind('/');
+        std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+        int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (dfd < 0) return false;
+        ok = ::fsync(dfd) == 0;
+        ::close(dfd);
+        return ok;
+    }
+
+    // Restores a checkpoint; the saved pegs must match the state computed
+    // from the move index, so a corrupted file is rejected.
+    static bool load_checkpoint(const std::string &path, BigMoveStream &out, std::string &error) {
+        std::ifstream f(path);
+        std::string magic, key, done_s, last_s, pegs_s;
+        int version = 0, n = -1;
+        if (!(f >> magic >> version) || magic != "hanoi-checkpoint" || version != 1) { error = "not a checkpoint file"; return false; }
+        if (!(f >> key >> n) || key != "n" || n < 0 || n > MAX_BIG_DISKS) { error = "bad disk count"; return false; }
+        u128 done, last;
+        if (!(f >> key >> done_s) || key != "done" || !parse_u128(done_s, done)) { error = "bad move index"; return false; }
+        if (!(f >> key >> last_s) || key != "last" || !parse_u128(last_s, last)) { error = "bad last move"; return false; }
+        if (n > 0 && (!(f >> key >> pegs_s) || key != "pegs")) { error = "missing pegs"; return false; }
+        if (last > total_moves_u128(n) || done > last) { error = "move range out of bounds"; return false; }
+        out = BigMoveStream(n, done + 1, last);
+        if (out.peg_string() != pegs_s) { error = "peg state does not match move index"; return false; }
+        return true;
+    }
+
+private:
+    // +1 (A -> B -> C) or -1 (A -> C -> B), as a residue mod 3
+    int direction(int d) const { return (n - 1 - d) % 2 == 0 ? 2 : 1; }
+
+    int n;
+    u128 k, last;
+    u128 pegs[3];
+    bool failed;
+};
+
+static volatile std::sig_atomic_t big_stream_interrupted = 0;
+
+// Streams (and checks) a range of moves, saving checkpoints periodically,
+// on Ctrl-C and when --max-seconds expires. Returns the process exit code.
+inline int run_big_stream(int argc, char **argv) {
+    int n = -1;
+    std::string from_s, to_s, checkpoint, resume;
+    double every = 60, max_seconds = 0;
+    for (int i = 2; i < argc; i++) {
+        std::string a = argv[i];
+        if (i + 1 >= argc) { std::cerr << "Missing value for " << a << "\n"; return 2; }
+        std::string v = argv[++i];
+        if (a == "--n") n = std::atoi(v.c_str());
+        else if (a == "--from") from_s = v;
+        else if (a == "--to") to_s = v;
+        else if (a == "--checkpoint") checkpoint = v;
+        else if (a == "--every") every = std::atof(v.c_str());
+        else if (a == "--resume") resume = v;
+        else if (a == "--max-seconds") max_seconds = std::atof(v.c_str());
+        else { std::cerr << "Unknown option: " << a << "\n"; return 2; }
+    }
+
+    BigMoveStream stream(0, 1, 0);
+    if (!resume.empty()) {
+        std::string error;
+        if (!BigMoveStream::load_checkpoint(resume, stream, error)) {
+            std::cerr << "Cannot resume from " << resume << ": " << error << "\n";
+            return 1;
+        }
+    } else {
+        if (n < 0 || n > MAX_BIG_DISKS) { std::cerr << "--n must be between 0 and " << MAX_BIG_DISKS << "\n"; return 2; }
+        u128 total = total_moves_u128(n), first = 1, last = total;
+        if (!from_s.empty() && !parse_u128(from_s, first)) { std::cerr << "Invalid --from\n"; return 2; }
+        if (!to_s.empty() && !parse_u128(to_s, last)) { std::cerr << "Invalid --to\n"; return 2; }
+        if (first < 1 || last > total || (first > last && total > 0)) {
+            std::cerr << "Move range must satisfy 1 <= from <= to <= 2^n - 1\n";
+            return 2;
+        }
+        stream = BigMoveStream(n, first, last);
+    }
+
+    std::signal(SIGINT, [](int) { big_stream_interrupted = 1; });
+    auto start = std::chrono::steady_clock::now(), last_save = start;
+    u128 start_index = stream.moves_done(), processed = 0;
+    Move m;
+    while (stream.next(m)) {
+        if ((++processed & 0xFFFFF) != 0) continue;
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - start).count();
+        if (big_stream_interrupted || (max_seconds > 0 && elapsed >= max_seconds)) break;
+        if (!checkpoint.empty() && std::chrono::duration<double>(now - last_save).count() >= every) {
+            if (!stream.save_checkpoint(checkpoint)) std::cerr << "Cannot write checkpoint " << checkpoint << "\n";
+            last_save = now;
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!checkpoint.empty() && !stream.save_checkpoint(checkpoint)) {
+        std::cerr << "Cannot write checkpoint " << checkpoint << "\n";
+    }
+
+    std::cout << "\n------ RESULTS ------\n";
+    std::cout << "Disks: " << stream.disks() << "\n";
+    std::cout << "Moves processed: " << u128_to_string(stream.moves_done() - start_index) << "\n";
+    std::cout << "Position: move " << u128_to_string(stream.moves_done()) << " of "
+              << u128_to_string(total_moves_u128(stream.disks())) << " (range ends at "
+              << u128_to_string(stream.last_move()) << ")\n";
+    std::cout << "Time: " << elapsed << " seconds\n";
+    if (elapsed > 0) std::cout << "Rate: " << (double)(stream.moves_done() - start_index) / elapsed / 1e6 << " Mmoves/s\n";
+    if (stream.illegal_move()) {
+        std::cout << "ERROR: illegal move at index " << u128_to_string(stream.moves_done()) << "\n";
+        return 1;
+    }
+    if (!stream.done()) std::cout << "Stopped before the end of the range" << (checkpoint.empty() ? "" : ", checkpoint saved") << "\n";
+    else if (stream.last_move() == total_moves_u128(stream.disks()))
+        std::cout << "Final state: " << (stream.solved() ? "all disks on C" : "INVALID") << "\n";
+    std::cout << "---------------------\n";
+    return stream.done() && stream.last_move() == total_moves_u128(stream.disks()) && !stream.solved() ? 1 : 0;
+}
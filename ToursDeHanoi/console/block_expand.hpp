@@ -0,0 +1,81 @@
+// block_expand.hpp — génération par blocs à partir d'une petite solution
+// La solution à n disques est faite de 2^(n-k) copies de la solution à k
+// disques, les piquets renommés, séparées par un seul mouvement (un des
+// grands disques). La solution de base (k = 16, 65535 mouvements) est
+// calculée une fois puis renommée pour les 6 permutations de piquets :
+// chaque bloc est alors une simple copie (memcpy) d'une de ces 6 tables.
+// Avant le bloc j, les k petits disques sont tous sur le même piquet, qui
+// suit le cycle du disque k (A -> C -> B si n - k est pair, A -> B -> C sinon).
+#pragma once
+#include <cstring>
+#include <vector>
+#include "closed_form.hpp"
+#include "packed_moves.hpp"
+
+const int BLOCK_BASE_DISKS = 16;
+
+class BlockTables {
+public:
+    static const BlockTables &get() {
+        static const BlockTables tables;  // thread-safe, built on first use
+        return tables;
+    }
+
+    // Base solution renamed so that A -> from and C -> to (index: encode_move)
+    const Move *block(char from, char to) const { return perm[encode_move({from, to})].data(); }
+
+private:
+    BlockTables() {
+        const unsigned long long len = (1ULL << BLOCK_BASE_DISKS) - 1;
+        std::vector<unsigned char> base(len);
+        for (unsigned long long k = 1; k <= len; k++) base[k - 1] = (unsigned char)encode_move(move_at(BLOCK_BASE_DISKS, k));
+        for (unsigned p = 0; p < 6; p++) {
+            // peg relabeling for permutation p, applied to the 6 move codes
+            Move target = decode_move(p);
+            char name[3] = {target.first, third(target.first, target.second), target.second};
+            Move lut[6];
+            for (unsigned c = 0; c < 6; c++) {
+                Move m = decode_move(c);
+                lut[c] = {name[m.first - 'A'], name[m.second - 'A']};
+            }
+            perm[p].resize(len);
+            for (unsigned long long i = 0; i < len; i++) perm[p][i] = lut[base[i]];
+        }
+    }
+
+    static char third(char x, char y) { return (char)('A' + 'B' + 'C' - x - y); }
+
+    std::vector<Move> perm[6];
+};
+
+// Disks per block: the whole solution when n < 16
+inline int block_disks(int n) { return n < BLOCK_BASE_DISKS ? n : BLOCK_BASE_DISKS; }
+
+// Blocks [first, last) of the n-disk solution, block j followed by its
+// separator; out receives move index first << block_disks(n) onwards
+inline void hanoi_block_range(int n, unsigned long long first, unsigned long long last, Move *out) {
+    const BlockTables &tables = BlockTables::get();
+    int m = block_disks(n);
+    unsigned long long len = (1ULL << m) - 1, blocks = 1ULL << (n - m);
+    // the first 2^m - 1 base moves take m disks from A to C (k - m even) or B
+    bool toB = (BLOCK_BASE_DISKS - m) % 2 == 1;
+    unsigned step = (n - m) % 2 == 0 ? 2 : 1;
+    const char name[3] = {'A', 'B', 'C'};
+    for (unsigned long long j = first; j < last; j++) {
+        char from = name[(j % 3) * step % 3], to = name[((j + 1) % 3) * step % 3];
+        const char *src = (const char *)tables.block(from, toB ? (char)('A' + 'B' + 'C' - from - to) : to);
+        Move *dst = out + ((j - first) << m);
+        std::memcpy((void *)dst, src, len * sizeof(Move));
+        // single move of a larger disk between blocks j and j + 1
+        if (j + 1 < blocks) dst[len] = move_at(n, (j + 1) << m);
+    }
+}
+
+// Fills out[0 .. 2^n - 2]; blocks are split between threads
+inline void hanoi_block_expand(int n, Move *out, unsigned threads) {
+    if (n == 0) return;
+    int m = block_disks(n);
+    parallel_move_slices(1ULL << (n - m), threads, 1, [=](unsigned long long first, unsigned long long last) {
+        hanoi_block_range(n, first - 1, last, out + ((first - 1) << m));
+    });
+}
@@ -0,0 +1,93 @@
+// closed_form.hpp — calcul direct du k-ième mouvement de la solution optimale
+// Le mouvement k (1 <= k <= 2^n - 1) se déduit des bits de k :
+//   disque déplacé : ctz(k) + 1
+//   piquet source  : (k & (k - 1)) % 3
+//   piquet cible   : ((k | (k - 1)) + 1) % 3
+// avec les piquets 1 et 2 échangés quand n est pair.
+#pragma once
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "hanoi_stream.hpp"
+
+// Number of the disk moved at step k (1 = smallest)
+inline int disk_at(unsigned long long k) { return __builtin_ctzll(k) + 1; }
+
+// Move k of the optimal solution moving n disks from A to C
+inline Move move_at(int n, unsigned long long k, char A = 'A', char C = 'C', char B = 'B') {
+    char name[3] = {A, B, C};
+    if (n % 2 == 0) std::swap(name[1], name[2]);
+    return {name[(k & (k - 1)) % 3], name[((k | (k - 1)) + 1) % 3]};
+}
+
+// Peg of every disk after k moves (result[d - 1] for disk d), in O(n) from
+// the bits of k: disk d has moved ((k >> (d - 1)) + 1) >> 1 times, always
+// in the same cyclic direction (A -> C -> B when n - d is even, else
+// A -> B -> C). Valid for n <= 63.
+inline std::vector<char> state_after(int n, unsigned long long k, char A = 'A', char C = 'C', char B = 'B') {
+    const char name[3] = {A, B, C};
+    std::vector<char> pegs(n);
+    for (int d = 1; d <= n; d++) {
+        unsigned long long count = ((k >> (d - 1)) + 1) >> 1;
+        unsigned step = (n - d) % 2 == 0 ? 2 : 1;
+        pegs[d - 1] = name[(count % 3) * step % 3];
+    }
+    return pegs;
+}
+
+// Stateless stream: each move only depends on its index
+class ClosedFormMoveStream {
+public:
+    ClosedFormMoveStream(int n, char A, char C, char B)
+        : n(n), total((1ULL << n) - 1), k(0), A(A), B(B), C(C) {}
+
+    bool next(Move &m) {
+        if (k >= total) return false;
+        m = move_at(n, ++k, A, C, B);
+        return true;
+    }
+
+    MoveIterator<ClosedFormMoveStream> begin() { return MoveIterator<ClosedFormMoveStream>(this); }
+    MoveIterator<ClosedFormMoveStream> end() { return MoveIterator<ClosedFormMoveStream>(); }
+
+private:
+    int n;
+    unsigned long long total, k;
+    char A, B, C;
+};
+
+inline unsigned default_thread_count() {
+    unsigned t = std::thread::hardware_concurrency();
+    return t ? t : 1;
+}
+
+// Splits moves [1, total] into one contiguous slice per thread.
+// Slice boundaries are multiples of `align` so that threads never share
+// a storage word in packed buffers. fn(first, last) handles [first, last].
+template <class Fn>
+void parallel_move_slices(unsigned long long total, unsigned threads, unsigned align, Fn fn) {
+    if (threads <= 1 || total < 2ULL * threads * align) {
+        if (total) fn(1ULL, total);
+        return;
+    }
+    unsigned long long per = (total + threads - 1) / threads;
+    per = (per + align - 1) / align * align;
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        unsigned long long first = (unsigned long long)t * per + 1;
+        if (first > total) break;
+        unsigned long long last = std::min(total, first + per - 1);
+        pool.emplace_back(fn, first, last);
+    }
+    for (auto &th : pool) th.join();
+}
+
+// Fills out[0 .. 2^n - 2] with the whole solution, one slice per thread
+inline void hanoi_closed_form(int n, Move *out, unsigned threads, char A = 'A', char C = 'C', char B = 'B') {
+    unsigned long long total = (1ULL << n) - 1;
+    parallel_move_slices(total, threads, 1, [=](unsigned long long first, unsigned long long last) {
+        for (unsigned long long k = first; k <= last; k++) out[k - 1] = move_at(n, k, A, C, B);
+    });
+}
@@ -0,0 +1,115 @@
+// config_solver.hpp — plus court chemin entre deux configurations quelconques
+// Une configuration donne le piquet de chaque disque (indice d-1 pour le
+// disque d, comme state_after). Toute configuration est légale : sur un
+// piquet, les disques sont forcément empilés du plus grand au plus petit.
+//
+// Soit D le plus grand disque mal placé. Le chemin optimal déplace D une
+// fois (via le troisième piquet pour les petits disques) ou deux fois
+// (en passant par le troisième piquet) ; les deux coûts se calculent en
+// O(n), puis la solution est émise comme une suite de tours classiques.
+#pragma once
+#include <string>
+#include <vector>
+#include "hanoi_stream.hpp"
+
+using Config = std::vector<char>;
+
+// 'A' + 'B' + 'C' - x - y
+inline char third_peg(char x, char y) { return (char)('A' + 'B' + 'C' - x - y); }
+
+// "AABC" -> config (disk 1 first); false if a character is not A, B or C
+inline bool parse_config(const std::string &s, Config &out) {
+    out.assign(s.begin(), s.end());
+    for (char c : out) if (c != 'A' && c != 'B' && c != 'C') return false;
+    return true;
+}
+
+// Tower of `disks` disks from -> to via the third peg (disks == 1: one move)
+struct TowerSegment {
+    int disks;
+    char from, to;
+};
+
+// Gathering disks 1..m of `conf` onto peg p, as towers (in execution order).
+// Going down from disk m, the target of the smaller disks switches to the
+// third peg each time disk i is not already on its target.
+inline std::vector<TowerSegment> gather_plan(const Config &conf, int m, char p) {
+    std::vector<char> target(m + 1);
+    for (int i = m; i >= 1; i--) {
+        target[i] = p;
+        if (conf[i - 1] != p) p = third_peg(conf[i - 1], p);
+    }
+    std::vector<TowerSegment> plan;
+    for (int i = 1; i <= m; i++) {
+        if (conf[i - 1] == target[i]) continue;
+        plan.push_back({1, conf[i - 1], target[i]});                                  // disk i
+        if (i > 1) plan.push_back({i - 1, third_peg(conf[i - 1], target[i]), target[i]}); // disks 1..i-1 on top
+    }
+    return plan;
+}
+
+// Moves needed by gather_plan: 2^(i-1) for every misplaced level i
+inline unsigned long long gather_cost(const Config &conf, int m, char p) {
+    unsigned long long cost = 0;
+    for (int i = m; i >= 1; i--) {
+        if (conf[i - 1] != p) {
+            cost += 1ULL << (i - 1);
+            p = third_peg(conf[i - 1], p);
+        }
+    }
+    return cost;
+}
+
+// Reverse of a plan: towers in reverse order, each one reversed
+inline void append_reversed(std::vector<TowerSegment> &out, const std::vector<TowerSegment> &plan) {
+    for (auto it = plan.rbegin(); it != plan.rend(); ++it) out.push_back({it->disks, it->to, it->from});
+}
+
+// Shortest sequence from `src` to `dst` (same number of disks, n <= 63)
+class ConfigMoveStream {
+public:
+    ConfigMoveStream(const Config &src, const Config &dst) : total(0), seg(0), tower(0, 'A', 'C', 'B') {
+        int D = (int)src.size();
+        while (D > 0 && src[D - 1] == dst[D - 1]) D--;
+        if (D == 0) return;
+
+        char a = src[D - 1], b = dst[D - 1], c = third_peg(a, b);
+        unsigned long long once = gather_cost(src, D - 1, c) + 1 + gather_cost(dst, D - 1, c);
+        unsigned long long twice = gather_cost(src, D - 1, b) + 1 + ((1ULL << (D - 1)) - 1) + 1 +
+                                   gather_cost(dst, D - 1, a);
+        if (once <= twice) {
+            plan = gather_plan(src, D - 1, c);
+            plan.push_back({1, a, b});
+            append_reversed(plan, gather_plan(dst, D - 1, c));
+            total = once;
+        } else {
+            plan = gather_plan(src, D - 1, b);
+            plan.push_back({1, a, c});
+            if (D > 1) plan.push_back({D - 1, b, a});
+            plan.push_back({1, c, b});
+            append_reversed(plan, gather_plan(dst, D - 1, a));
+            total = twice;
+        }
+    }
+
+    unsigned long long size() const { return total; }
+    const std::vector<TowerSegment> &segments() const { return plan; }
+
+    bool next(Move &m) {
+        while (!tower.next(m)) {
+            if (seg >= plan.size()) return false;
+            const TowerSegment &s = plan[seg++];
+            tower = RecursiveMoveStream(s.disks, s.from, s.to, third_peg(s.from, s.to));
+        }
+        return true;
+    }
+
+    MoveIterator<ConfigMoveStream> begin() { return MoveIterator<ConfigMoveStream>(this); }
+    MoveIterator<ConfigMoveStream> end() { return MoveIterator<ConfigMoveStream>(); }
+
+private:
+    std::vector<TowerSegment> plan;
+    unsigned long long total;
+    size_t seg;
+    RecursiveMoveStream tower;
+};
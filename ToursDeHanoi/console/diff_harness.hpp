@@ -0,0 +1,132 @@
+// diff_harness.hpp — comparaison de générateurs par hachage combinable
+// La solution de n disques est découpée en 2^(n-m) tranches : la tranche j
+// est la tour de m disques numéro j (piquets renommés, comme block_expand)
+// suivie du mouvement séparateur d'un grand disque, soit les mouvements
+// [j 2^m, (j+1) 2^m). Chaque tranche est hachée indépendamment (en
+// parallèle) par un hachage polynomial modulo 2^61 - 1, qui dépend de la
+// position : H(X.Y) = H(X) R^|Y| + H(Y), donc les tranches se combinent.
+// En cas de différence, la première tranche différente est régénérée par
+// les deux générateurs pour trouver l'indice exact du premier mouvement.
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "closed_form.hpp"
+#include "packed_moves.hpp"
+
+const uint64_t HASH_MOD = (1ULL << 61) - 1;
+const uint64_t HASH_BASE = 0x1F3D5B79A2C4E681ULL % HASH_MOD;
+
+inline uint64_t mul_mod61(uint64_t a, uint64_t b) {
+    __uint128_t p = (__uint128_t)a * b;
+    uint64_t s = (uint64_t)(p & HASH_MOD) + (uint64_t)(p >> 61);
+    return s >= HASH_MOD ? s - HASH_MOD : s;
+}
+
+inline uint64_t pow_mod61(uint64_t b, unsigned long long e) {
+    uint64_t r = 1;
+    for (; e; e >>= 1, b = mul_mod61(b, b)) if (e & 1) r = mul_mod61(r, b);
+    return r;
+}
+
+// Horner over the moves (value = move code + 1)
+struct HashSink {
+    uint64_t hash = 0;
+    unsigned long long count = 0;
+    void operator()(char from, char to) {
+        uint64_t h = mul_mod61(hash, HASH_BASE) + encode_move({from, to}) + 1;
+        hash = h >= HASH_MOD ? h - HASH_MOD : h;
+        ++count;
+    }
+};
+
+struct CollectSink {
+    std::vector<Move> moves;
+    void operator()(char from, char to) { moves.push_back({from, to}); }
+};
+
+// Geometry of the chunks of the n-disk solution
+struct ChunkPlan {
+    int n, m;
+    unsigned long long chunks;
+
+    ChunkPlan(int n, int m) : n(n), m(m < n ? m : n), chunks(1ULL << (n - this->m)) {}
+
+    unsigned long long first(unsigned long long j) const { return j << m; }
+    unsigned long long count(unsigned long long j) const { return j + 1 < chunks ? 1ULL << m : (1ULL << m) - 1; }
+
+    // chunk j moves m disks from -> to (cycle A -> C -> B when n - m is even)
+    void tower(unsigned long long j, char &from, char &to, char &via) const {
+        const char name[3] = {'A', 'B', 'C'};
+        unsigned step = (n - m) % 2 == 0 ? 2 : 1;
+        from = name[(j % 3) * step % 3];
+        to = name[((j + 1) % 3) * step % 3];
+        via = (char)('A' + 'B' + 'C' - from - to);
+    }
+
+    // Chunk j from a tower generator gen(m, from, to, via, sink) + separator
+    template <class TowerGen, class Sink>
+    void run_tower(unsigned long long j, TowerGen &gen, Sink &sink) const {
+        char from, to, via;
+        tower(j, from, to, via);
+        gen(m, from, to, via, sink);
+        if (j + 1 < chunks) {
+            Move s = move_at(n, (j + 1) << m);
+            sink(s.first, s.second);
+        }
+    }
+};
+
+// Hash of each selected chunk; chunk(j, sink) emits the moves of chunk j
+template <class ChunkGen>
+std::vector<uint64_t> chunk_hashes(const std::vector<unsigned long long> &selected, unsigned threads, ChunkGen chunk,
+                                   unsigned long long &moves) {
+    std::vector<uint64_t> out(selected.size());
+    std::atomic<size_t> next(0);
+    std::atomic<unsigned long long> total(0);
+    auto worker = [&] {
+        unsigned long long local = 0;
+        for (size_t i; (i = next.fetch_add(1)) < selected.size();) {
+            HashSink sink;
+            chunk(selected[i], sink);
+            out[i] = sink.hash;
+            local += sink.count;
+        }
+        total += local;
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool) t.join();
+    moves = total.load();
+    return out;
+}
+
+// Hash of the whole solution from all chunk hashes, in order
+inline uint64_t combine_chunks(const ChunkPlan &plan, const std::vector<uint64_t> &hashes) {
+    uint64_t full = pow_mod61(HASH_BASE, 1ULL << plan.m), last = pow_mod61(HASH_BASE, (1ULL << plan.m) - 1);
+    uint64_t h = 0;
+    for (size_t j = 0; j < hashes.size(); j++) {
+        uint64_t s = mul_mod61(h, j + 1 < hashes.size() ? full : last) + hashes[j];
+        h = s >= HASH_MOD ? s - HASH_MOD : s;
+    }
+    return h;
+}
+
+// First differing move index in chunk j (-1 if equal), regenerating it with both
+template <class ChunkGenA, class ChunkGenB>
+long long first_difference(const ChunkPlan &plan, unsigned long long j, ChunkGenA a, ChunkGenB b, Move &expected,
+                           Move &got) {
+    CollectSink x, y;
+    a(j, x);
+    b(j, y);
+    size_t len = std::max(x.moves.size(), y.moves.size());
+    for (size_t i = 0; i < len; i++) {
+        expected = i < x.moves.size() ? x.moves[i] : Move{'-', '-'};
+        got = i < y.moves.size() ? y.moves[i] : Move{'-', '-'};
+        if (expected != got) return (long long)(plan.first(j) + i);
+    }
+    return -1;
+}
@@ -0,0 +1,150 @@
+// frame_stewart.hpp — Tours de Hanoi à k piquets (k >= 3), algorithme de Frame–Stewart
+// FS(n, p) : déplacer t disques vers un piquet libre (p piquets), puis les
+// n - t restants avec p - 1 piquets, puis les t disques par-dessus.
+// Le t optimal et le nombre de coups viennent d'une table DP mémorisée.
+// Les piquets sont nommés 'A', 'B', ... ; la tour va de A vers le dernier.
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "hanoi_stream.hpp"
+#include "replay.hpp"
+
+const int MAX_PEGS = 26;
+const uint64_t FS_SATURATED = ~0ULL;  // move count does not fit in 64 bits
+
+// cost[p][n] = minimal Frame–Stewart move count, split[p][n] = t
+class FrameStewartTable {
+public:
+    // Shared table covering at least n disks and p pegs. A larger request
+    // builds a new table; holders of the previous one keep it alive.
+    static std::shared_ptr<const FrameStewartTable> get(int n, int p) {
+        static std::shared_ptr<FrameStewartTable> table;
+        static std::mutex m;
+        std::lock_guard<std::mutex> lock(m);
+        if (!table || n > table->maxDisks || p > table->maxPegs) {
+            auto bigger = std::make_shared<FrameStewartTable>();
+            bigger->build(std::max(n, table ? table->maxDisks : 0), std::max(p, table ? table->maxPegs : 3));
+            table = bigger;
+        }
+        return table;
+    }
+
+    uint64_t moves(int n, int p) const { return cost[p][n]; }
+    int split(int n, int p) const { return best[p][n]; }
+
+private:
+    static uint64_t add_sat(uint64_t a, uint64_t b) { return a > FS_SATURATED - b ? FS_SATURATED : a + b; }
+
+    void build(int n, int p) {
+        maxDisks = n;
+        maxPegs = p;
+        cost.assign(p + 1, std::vector<uint64_t>(n + 1, 0));
+        best.assign(p + 1, std::vector<int>(n + 1, 0));
+        for (int i = 1; i <= n; i++) cost[3][i] = i >= 64 ? FS_SATURATED : (1ULL << i) - 1;
+        for (int q = 4; q <= p; q++) {
+            for (int i = 1; i <= n; i++) {
+                uint64_t bestCost = FS_SATURATED;
+                int bestT = i - 1;
+                // cost is convex in t: stop once it starts increasing
+                for (int t = 1; t < i; t++) {
+                    uint64_t c = add_sat(add_sat(cost[q][t], cost[q][t]), cost[q - 1][i - t]);
+                    if (c < bestCost) { bestCost = c; bestT = t; }
+                    else if (c > bestCost) break;
+                }
+                cost[q][i] = i == 1 ? 1 : bestCost;
+                best[q][i] = i == 1 ? 0 : bestT;
+            }
+        }
+    }
+
+    int maxDisks = 0, maxPegs = 3;
+    std::vector<std::vector<uint64_t>> cost;
+    std::vector<std::vector<int>> best;
+};
+
+inline uint64_t frame_stewart_moves(int n, int pegs) { return FrameStewartTable::get(n, pegs)->moves(n, pegs); }
+
+// Same next()/range interface as the 3-peg streams, explicit stack
+class FrameStewartMoveStream {
+public:
+    FrameStewartMoveStream(int n, int pegs) : table(FrameStewartTable::get(n, pegs)) {
+        stack.reserve(2 * n + 4);
+        if (n > 0) stack.push_back({n, 0, pegs - 1, (1u << pegs) - 1, 0, 0});
+    }
+
+    bool next(Move &m) {
+        while (!stack.empty()) {
+            Frame f = stack.back();
+            int p = __builtin_popcount(f.pegs);
+            uint32_t others = f.pegs & ~(1u << f.from) & ~(1u << f.to);
+            int spare = __builtin_ctz(others);  // lowest free peg
+
+            if (f.n == 1) {
+                stack.pop_back();
+                m = {char('A' + f.from), char('A' + f.to)};
+                return true;
+            }
+            if (p == 3) {
+                // classic recursion: n-1 to spare, move, n-1 on top
+                if (f.stage == 0) {
+                    stack.back().stage = 1;
+                    stack.push_back({f.n - 1, f.from, spare, f.pegs, 0, 0});
+                } else {
+                    stack.back() = {f.n - 1, spare, f.to, f.pegs, 0, 0};
+                    m = {char('A' + f.from), char('A' + f.to)};
+                    return true;
+                }
+                continue;
+            }
+            int t = table->split(f.n, p);
+            if (f.stage == 0) {
+                stack.back().stage = 1;
+                stack.back().via = spare;
+                stack.push_back({t, f.from, spare, f.pegs, 0, 0});
+            } else if (f.stage == 1) {
+                stack.back().stage = 2;
+                stack.push_back({f.n - t, f.from, f.to, f.pegs & ~(1u << f.via), 0, 0});
+            } else {
+                stack.back() = {t, f.via, f.to, f.pegs, 0, 0};
+            }
+        }
+        return false;
+    }
+
+    MoveIterator<FrameStewartMoveStream> begin() { return MoveIterator<FrameStewartMoveStream>(this); }
+    MoveIterator<FrameStewartMoveStream> end() { return MoveIterator<FrameStewartMoveStream>(); }
+
+private:
+    struct Frame {
+        int n, from, to;
+        uint32_t pegs;  // usable pegs (bit i = peg 'A' + i)
+        int stage, via;
+    };
+
+    std::shared_ptr<const FrameStewartTable> table;
+    std::vector<Frame> stack;
+};
+
+// Replays moves on `pegs` stacks (any n); solved = every disk on the last peg
+template <class Range>
+ReplayResult replay_multi_peg(int n, int pegs, Range &&moves) {
+    std::vector<std::vector<int>> st(pegs);
+    for (int d = n; d >= 1; d--) st[0].push_back(d);
+    ReplayResult r;
+    for (Move m : moves) {
+        unsigned f = (unsigned)(m.first - 'A'), t = (unsigned)(m.second - 'A');
+        if (f >= (unsigned)pegs || t >= (unsigned)pegs || f == t || st[f].empty() ||
+            (!st[t].empty() && st[t].back() < st[f].back())) {
+            r.error_index = r.applied;
+            return r;
+        }
+        st[t].push_back(st[f].back());
+        st[f].pop_back();
+        r.applied++;
+    }
+    r.solved = (int)st[pegs - 1].size() == n;
+    return r;
+}
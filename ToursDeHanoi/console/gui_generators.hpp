@@ -0,0 +1,49 @@
+// gui_generators.hpp — générateurs de l'interface graphique (hanoiRec/hanoiIter)
+// Ici avec les autres générateurs : graphics/ les inclut, et la console les
+// compare aux siens (./hanoi --diff) sans dépendre de graphics/.
+#pragma once
+#include <utility>
+#include <vector>
+
+// Hanoi recursive moves generator (each move goes to sink(from, to))
+template<class Sink>
+void hanoiRec(int n, char A, char C, char B, Sink &sink){
+    if(n != 0){
+        hanoiRec(n-1, A, B, C, sink);
+        sink(A, C); // Move(A, C)
+        hanoiRec(n-1, B, C, A, sink);
+    }
+}
+// Hanoi iterative (simulation) moves generator
+template<class Sink>
+void hanoiIter(int n, char A, char C, char B, Sink &sink){
+    struct Peg { std::vector<int> s; };
+    Peg pegA, pegB, pegC;
+    for(int i=n;i>=1;--i) pegA.s.push_back(i);
+
+    auto mv = [&](Peg& P1, Peg& P2, char c1, char c2){
+        if(P1.s.empty()){
+            sink(c2,c1);
+            P1.s.push_back(P2.s.back()); P2.s.pop_back();
+        } else if(P2.s.empty()){
+            sink(c1,c2);
+            P2.s.push_back(P1.s.back()); P1.s.pop_back();
+        } else if(P1.s.back() < P2.s.back()){
+            sink(c1,c2);
+            P2.s.push_back(P1.s.back()); P1.s.pop_back();
+        } else {
+            sink(c2,c1);
+            P1.s.push_back(P2.s.back()); P2.s.pop_back();
+        }
+    };
+
+    char p1 = A, p2 = B, p3 = C;
+    if(n % 2 == 0) std::swap(p2,p3);
+
+    long long total = (1LL<<n) - 1;
+    for(long long i=1;i<=total;++i){
+        if(i%3==1) mv(pegA, pegC, p1, p3);
+        else if(i%3==2) mv(pegA, pegB, p1, p2);
+        else mv(pegB, pegC, p2, p3);
+    }
+}
@@ -0,0 +1,117 @@
+// hanoi_stream.hpp — générateurs de mouvements "à la demande"
+// Chaque générateur produit les mouvements un par un avec un état O(n),
+// sans jamais stocker la solution complète.
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+using Move = std::pair<char, char>;  // (from, to)
+
+// Input iterator over any stream exposing `bool next(Move &)`
+template <class Stream>
+class MoveIterator {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Move;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Move *;
+    using reference = const Move &;
+
+    MoveIterator() : stream(nullptr) {}
+    explicit MoveIterator(Stream *s) : stream(s) { advance(); }
+
+    reference operator*() const { return current; }
+    pointer operator->() const { return &current; }
+    MoveIterator &operator++() { advance(); return *this; }
+    void operator++(int) { advance(); }
+
+    bool operator==(const MoveIterator &o) const { return stream == o.stream; }
+    bool operator!=(const MoveIterator &o) const { return stream != o.stream; }
+
+private:
+    void advance() {
+        if (stream && !stream->next(current)) stream = nullptr;
+    }
+
+    Stream *stream;
+    Move current;
+};
+
+// Recursive algorithm, with the call stack made explicit (at most n frames)
+class RecursiveMoveStream {
+public:
+    RecursiveMoveStream(int n, char A, char C, char B) {
+        stack.reserve(n > 0 ? n : 0);
+        if (n > 0) stack.push_back({n, A, C, B, false});
+    }
+
+    bool next(Move &m) {
+        while (!stack.empty()) {
+            Frame &f = stack.back();
+            // hanoi(n-1, from, via, to) first
+            if (!f.leftDone) {
+                f.leftDone = true;
+                if (f.n > 1) {
+                    stack.push_back({f.n - 1, f.from, f.via, f.to, false});
+                    continue;
+                }
+            }
+            // Move(from, to), then hanoi(n-1, via, to, from) replaces this frame
+            m = {f.from, f.to};
+            Frame right{f.n - 1, f.via, f.to, f.from, false};
+            stack.pop_back();
+            if (right.n > 0) stack.push_back(right);
+            return true;
+        }
+        return false;
+    }
+
+    MoveIterator<RecursiveMoveStream> begin() { return MoveIterator<RecursiveMoveStream>(this); }
+    MoveIterator<RecursiveMoveStream> end() { return MoveIterator<RecursiveMoveStream>(); }
+
+private:
+    struct Frame { int n; char from, to, via; bool leftDone; };
+    std::vector<Frame> stack;
+};
+
+// Iterative algorithm (same rules as hanoi_iterative), one move per call
+class IterativeMoveStream {
+public:
+    IterativeMoveStream(int n, char A, char C, char B)
+        : total((1LL << n) - 1), i(0) {
+        if (n % 2 == 0) std::swap(C, B);
+        name[0] = A; name[1] = B; name[2] = C;
+        for (auto &p : pegs) p.reserve(n);
+        for (int d = n; d >= 1; d--) pegs[0].push_back(d);
+    }
+
+    bool next(Move &m) {
+        if (i >= total) return false;
+        ++i;
+        if (i % 3 == 1) m = moveBetween(0, 2);       // A <-> C
+        else if (i % 3 == 2) m = moveBetween(0, 1);  // A <-> B
+        else m = moveBetween(1, 2);                  // B <-> C
+        return true;
+    }
+
+    MoveIterator<IterativeMoveStream> begin() { return MoveIterator<IterativeMoveStream>(this); }
+    MoveIterator<IterativeMoveStream> end() { return MoveIterator<IterativeMoveStream>(); }
+
+private:
+    // Legal move between pegs p and q: the smaller top disk goes on the other peg
+    Move moveBetween(int p, int q) {
+        std::vector<int> &P = pegs[p], &Q = pegs[q];
+        if (P.empty() || (!Q.empty() && Q.back() < P.back())) {
+            P.push_back(Q.back()); Q.pop_back();
+            return {name[q], name[p]};
+        }
+        Q.push_back(P.back()); P.pop_back();
+        return {name[p], name[q]};
+    }
+
+    long long total, i;
+    char name[3];  // A, B, C (B and C swapped when n is even)
+    std::vector<int> pegs[3];
+};
@@ -1,19 +1,58 @@
 #include <iostream>
 #include <chrono>
+#include <cstdlib>
 #include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include "hanoi_stream.hpp"
+#include "packed_moves.hpp"
+#include "closed_form.hpp"
+#include "work_stealing.hpp"
+#include "simd_kernel.hpp"
+#include "benchmark.hpp"
+#include "big_stream.hpp"
+#include "replay.hpp"
+#include "frame_stewart.hpp"
+#include "config_solver.hpp"
+#include "perf_counters.hpp"
+#include "move_file.hpp"
+#include "move_sinks.hpp"
+#include "block_expand.hpp"
+#include "query_server.hpp"
+#include "diff_harness.hpp"
+#include "move_arena.hpp"
+#include "gui_generators.hpp"
+#include <csignal>
 using namespace std;
 
 vector<pair<char, char>> moves;  // Pour stocker les mouvements
 
-void hanoi_recursive(int n, char A, char C, char B) {
+// Compte les allocations (affichées avec les compteurs matériels).
+// new[] et la version nothrow passent par celui-ci, delete reste celui de
+// la bibliothèque (free).
+void *operator new(size_t size) {
+    alloc_counters().count.fetch_add(1, memory_order_relaxed);
+    alloc_counters().bytes.fetch_add(size, memory_order_relaxed);
+    if (void *p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+// Générateurs paramétrés par le sink (voir move_sinks.hpp) : une version
+// spécialisée par type de destination, appel au sink inliné
+template <class Sink>
+void hanoi_recursive(int n, char A, char C, char B, Sink &sink) {
     if (n != 0) {
-        hanoi_recursive(n - 1, A, B, C);
-        moves.push_back({A, C});  // Move(A, C)
-        hanoi_recursive(n - 1, B, C, A);
+        hanoi_recursive(n - 1, A, B, C, sink);
+        sink(A, C);  // Move(A, C)
+        hanoi_recursive(n - 1, B, C, A, sink);
     }
 }
 
-void hanoi_iterative(int n, char A, char C, char B) {
+template <class Sink>
+void hanoi_iterative(int n, char A, char C, char B, Sink &sink) {
     long long total_moves = (1LL << n) - 1;
     if (n % 2 == 0) swap(C, B);
 
@@ -25,7 +64,7 @@ void hanoi_iterative(int n, char A, char C, char B) {
     auto moveDisk = [&](char fromPeg, char toPeg, int &topFrom, int stackFrom[], int &topTo, int stackTo[]) {
         int disk = stackFrom[topFrom--];
         stackTo[++topTo] = disk;
-        moves.push_back({fromPeg, toPeg});
+        sink(fromPeg, toPeg);
     };
 
     for (long long i = 1; i <= total_moves; i++) {
@@ -55,53 +94,961 @@ void hanoi_iterative(int n, char A, char C, char B) {
         }
     }
 }
-int main() {
-    while (true) {
-        int n, choice;
-        cout << "Enter number of disks: ";
-        cin >> n;
 
-        cout << "\nChoose method:\n1 - Recursive\n2 - Iterative\nYour choice: ";
-        cin >> choice;
+// Vecteur global des mouvements, réservé à la bonne taille
+void hanoi_recursive(int n, char A, char C, char B) {
+    VectorSink sink(moves, (1ULL << n) - 1);
+    hanoi_recursive(n, A, C, B, sink);
+}
 
-        if (choice != 1 && choice != 2) {
-            cout << "Invalid choice. Try again.\n";
-            continue;
+void hanoi_iterative(int n, char A, char C, char B) {
+    VectorSink sink(moves, (1ULL << n) - 1);
+    hanoi_iterative(n, A, C, B, sink);
+}
+
+// Génère la solution de la méthode choisie (1 ou 2) directement dans le sink
+template <class Sink>
+void generate_into(int choice, int n, Sink &sink) {
+    if (choice == 1) hanoi_recursive(n, 'A', 'C', 'B', sink);
+    else hanoi_iterative(n, 'A', 'C', 'B', sink);
+}
+
+// Remplit un buffer compact avec le générateur de la méthode choisie
+template <class Buffer>
+void fill_from_generator(Buffer &buffer, int choice, int n) {
+    buffer.reserve((1ULL << n) - 1);
+    BufferSink<Buffer> sink(buffer);
+    generate_into(choice, n, sink);
+}
+
+// Remplissage par formule directe, chaque thread écrit sa propre tranche
+void fill_closed_form(PackedMoves &buffer, int n, unsigned threads) {
+    unsigned long long total = (1ULL << n) - 1;
+    buffer.resize(total);
+    parallel_move_slices(total, threads, PackedMoves::PER_WORD, [&](unsigned long long first, unsigned long long last) {
+        for (unsigned long long k = first; k <= last; k++) buffer.set_code(k - 1, encode_move(move_at(n, k)));
+    });
+}
+
+void fill_closed_form(DirectionMoves &buffer, int n, unsigned threads) {
+    unsigned long long total = (1ULL << n) - 1;
+    buffer.resize(total);
+    parallel_move_slices(total, threads, 64, [&](unsigned long long first, unsigned long long last) {
+        for (unsigned long long k = first; k <= last; k++) buffer.set(k - 1, move_at(n, k));
+    });
+}
+
+// Durée d'une génération matérialisée série (référence pour le speedup)
+double time_serial(int choice, int n) {
+    moves.clear();
+    auto start = chrono::high_resolution_clock::now();
+    if (choice == 1) hanoi_recursive(n, 'A', 'C', 'B');
+    else hanoi_iterative(n, 'A', 'C', 'B');
+    auto end = chrono::high_resolution_clock::now();
+    return chrono::duration<double>(end - start).count();
+}
+
+const vector<string> method_keys = {"rec", "iter", "closed", "parrec", "simd", "fs", "block"};
+const vector<string> mode_keys = {"vector", "stream", "packed3", "packed1", "count", "checksum", "file", "callback"};
+
+// Combinaisons méthode / mode / taille non disponibles (nullptr si valide)
+const char *unsupported(int choice, int mode, int n, int pegs, const string &buffer = "vector") {
+    if (buffer != "vector" && (mode != 1 || choice == 6)) return "--buffer thp|hugetlb only applies to mode 1 (not fs)";
+    if (mode >= 5 && choice > 2) return "sink modes 5 to 8 only support methods 1 and 2";
+    if (choice == 4 && mode != 1) return "parallel recursive method only supports mode 1";
+    if (choice == 5 && mode != 1 && mode != 4) return "SIMD method only supports modes 1 and 4";
+    if (choice == 7 && mode != 1) return "block expansion method only supports mode 1";
+    if (choice == 6) {
+        if (mode != 1 && mode != 2) return "Frame-Stewart method only supports modes 1 and 2";
+        if (pegs < 3 || pegs > MAX_PEGS) return "number of pegs must be between 3 and 26";
+        if (n < 0 || n > 1000) return "Frame-Stewart method supports 0 to 1000 disks";
+        if (frame_stewart_moves(n, pegs) > (1ULL << 62)) return "move count too large for this number of pegs";
+        return nullptr;
+    }
+    // 1LL << n et les piles de 64 disques : au-delà, utiliser --big
+    if (n < 0 || n > 62) return "number of disks must be between 0 and 62 (use --big for larger n)";
+    return nullptr;
+}
+
+// Frame–Stewart (k piquets) : matérialisé ou en flux, validé sur k piles
+void run_frame_stewart(int mode, int n, int pegs, RunResult &r, ReplayResult &replay, PerfCounters &perf) {
+    if (mode == 1) {
+        perf.start();
+        auto start_calc = chrono::high_resolution_clock::now();
+        moves.reserve(frame_stewart_moves(n, pegs));
+        FrameStewartMoveStream stream(n, pegs);
+        for (const Move &m : stream) moves.push_back(m);
+        auto end_calc = chrono::high_resolution_clock::now();
+        r.perf_calc = perf.stop();
+        r.time_calc = chrono::duration<double>(end_calc - start_calc).count();
+
+        perf.start();
+        auto start_exec = chrono::high_resolution_clock::now();
+        replay = replay_multi_peg(n, pegs, moves);
+        auto end_exec = chrono::high_resolution_clock::now();
+        r.perf_exec = perf.stop();
+        r.time_exec = chrono::duration<double>(end_exec - start_exec).count();
+        r.memory_bytes = moves.capacity() * sizeof(moves[0]);
+    } else {
+        moves.shrink_to_fit();
+        perf.start();
+        auto start_exec = chrono::high_resolution_clock::now();
+        FrameStewartMoveStream stream(n, pegs);
+        replay = replay_multi_peg(n, pegs, stream);
+        auto end_exec = chrono::high_resolution_clock::now();
+        r.perf_exec = perf.stop();
+        r.time_exec = chrono::duration<double>(end_exec - start_exec).count();
+    }
+}
+
+// Répertoire privé (mode 0700) sous $TMPDIR, supprimé avec ses fichiers
+struct SinkTempDir {
+    string dir, path;
+    SinkTempDir() {
+        const char *base = getenv("TMPDIR");
+        string pattern = string(base && *base ? base : "/tmp") + "/hanoi_sink_XXXXXX";
+        vector<char> buf(pattern.begin(), pattern.end());
+        buf.push_back('\0');
+        if (mkdtemp(buf.data())) {
+            dir = buf.data();
+            path = dir + "/moves.hmv";
+        }
+    }
+    ~SinkTempDir() {
+        if (dir.empty()) return;
+        ::unlink(path.c_str());
+        ::unlink((path + ".tmp").c_str());
+        ::rmdir(dir.c_str());
+    }
+};
+
+// Modes 5 à 8 : génération seule vers un sink spécialisé (comptage, somme de
+// contrôle, fichier, callback). La vérification se fait hors chronomètre :
+// somme de contrôle et moves par piquet comparés à la forme close, fichier
+// rejoué ; le mode 5 ne vérifie que le nombre de mouvements.
+void run_sink(int choice, int mode, int n, RunResult &r, ReplayResult &replay, PerfCounters &perf) {
+    unsigned long long total = (1ULL << n) - 1, produced = 0;
+    uint64_t hash = 0;
+    unsigned long long from_peg[3] = {0, 0, 0};
+    unique_ptr<SinkTempDir> temp;
+    if (mode == 7) temp.reset(new SinkTempDir);
+    bool written = false;
+
+    perf.start();
+    auto start_exec = chrono::high_resolution_clock::now();
+    if (mode == 5) {
+        CountSink sink;
+        generate_into(choice, n, sink);
+        produced = sink.count;
+    } else if (mode == 6) {
+        ChecksumSink sink;
+        generate_into(choice, n, sink);
+        produced = sink.count;
+        hash = sink.hash;
+    } else if (mode == 7) {
+        if (temp->dir.empty()) {
+            cerr << "Cannot create a temporary directory: " << strerror(errno) << "\n";
+        } else {
+            MoveFileWriter file(temp->path, n, ENCODING_PACKED3, total);
+            if (file.ok()) {
+                BufferSink<MoveFileWriter> sink(file);
+                generate_into(choice, n, sink);
+                written = file.finish(1);
+            }
+            if (!written) cerr << "Cannot write " << temp->path << ": " << file.error() << "\n";
         }
+    } else {
+        // any lambda: here, moves per source peg
+        auto sink = [&from_peg](char from, char) { from_peg[from - 'A']++; };
+        generate_into(choice, n, sink);
+        produced = from_peg[0] + from_peg[1] + from_peg[2];
+    }
+    auto end_exec = chrono::high_resolution_clock::now();
+    r.perf_exec = perf.stop();
+    r.time_exec = chrono::duration<double>(end_exec - start_exec).count();
+
+    replay.solved = true;
+    if (mode == 6) {
+        ChecksumSink expected;
+        for (const Move &m : ClosedFormMoveStream(n, 'A', 'C', 'B')) expected(m.first, m.second);
+        replay.solved = hash == expected.hash;
+    } else if (mode == 7 && written) {
+        MoveFile file;
+        string error;
+        replay = file.open(temp->path, error) ? replay_moves(n, file) : ReplayResult();
+        produced = replay.applied;
+        r.memory_bytes = 0;  // moves are on disk
+    } else if (mode == 8) {
+        unsigned long long expected[3] = {0, 0, 0};
+        for (const Move &m : ClosedFormMoveStream(n, 'A', 'C', 'B')) expected[m.first - 'A']++;
+        replay.solved = equal(from_peg, from_peg + 3, expected);
+    }
+    replay.applied = produced;
+    replay.solved = replay.solved && produced == total && (mode != 7 || written);
+}
 
-        moves.clear();  // Vider le vecteur pour chaque test
+// Une exécution complète : génération, exécution et temps total
+// buffer (mode 1) : "vector", ou un MoveArena en pages "thp" / "hugetlb"
+RunResult run_solver(int choice, int mode, int n, unsigned threads, int pegs = 4, const string &buffer = "vector") {
+    RunResult r;
+    ReplayResult replay;
+    PerfCounters perf;  // cycles, cache misses, allocations... per phase
+    moves.clear();  // Vider le vecteur pour chaque test
+    r.threads = ((choice >= 3 && choice <= 5) || choice == 7 ? threads : 1);
+    r.pegs = (choice == 6 ? pegs : 3);
 
-        // --- START TOTAL TIMER ---
-        auto start_total = chrono::high_resolution_clock::now();
+    // --- START TOTAL TIMER ---
+    auto start_total = chrono::high_resolution_clock::now();
 
+    if (choice == 6) {
+        run_frame_stewart(mode, n, pegs, r, replay, perf);
+    } else if (mode >= 5) {
+        moves.shrink_to_fit();
+        r.threads = 1;
+        run_sink(choice, mode, n, r, replay, perf);
+    } else if (mode == 1) {
         // 1. Timer pour le calcul de la solution (génération des mouvements)
+        // L'arène est allouée et placée dans ce chronomètre, comme le vecteur
+        MoveArena arena;
+        bool use_arena = buffer != "vector";
+        if (use_arena) moves.shrink_to_fit();  // libérer le vecteur d'un test précédent
+        perf.start();
+        auto start_calc = chrono::high_resolution_clock::now();
+        Move *out = nullptr;
+        if (use_arena) {
+            string error;
+            ArenaPages pages = buffer == "hugetlb" ? ArenaPages::Explicit : ArenaPages::Transparent;
+            if (!arena.allocate((1ULL << n) - 1, pages, threads, error)) {
+                r.perf_calc = perf.stop();
+                r.error = "cannot allocate the move arena: " + error;
+                return r;
+            }
+            out = arena.data();
+        } else if (choice >= 3) {
+            moves.resize((1ULL << n) - 1);
+            out = moves.data();
+        }
+        if (choice == 1 || choice == 2) {
+            if (use_arena) {
+                PointerSink sink{out};
+                generate_into(choice, n, sink);
+            } else if (choice == 1) {
+                hanoi_recursive(n, 'A', 'C', 'B');
+            } else {
+                hanoi_iterative(n, 'A', 'C', 'B');
+            }
+        } else if (choice == 3) {
+            hanoi_closed_form(n, out, threads);
+        } else if (choice == 4) {
+            WorkStealingPool pool(threads);
+            hanoi_recursive_parallel(pool, n, 'A', 'C', 'B', out, default_cutoff_depth(threads));
+        } else if (choice == 5) {
+            hanoi_simd(n, out, threads, detect_simd_level());
+        } else {
+            hanoi_block_expand(n, out, threads);
+        }
+        auto end_calc = chrono::high_resolution_clock::now();
+        r.perf_calc = perf.stop();
+        r.time_calc = chrono::duration<double>(end_calc - start_calc).count();
+
+        // 2. Timer pour l’exécution : rejouer et valider chaque mouvement
+        perf.start();
+        auto start_exec = chrono::high_resolution_clock::now();
+        if (use_arena) replay = replay_moves(n, arena);
+        else replay = replay_moves(n, moves);
+        auto end_exec = chrono::high_resolution_clock::now();
+        r.perf_exec = perf.stop();
+        r.time_exec = chrono::duration<double>(end_exec - start_exec).count();
+        r.memory_bytes = use_arena ? arena.bytes() : moves.capacity() * sizeof(moves[0]);
+        r.buffer = use_arena ? arena.kind() : "vector";
+    } else if (mode == 3 || mode == 4) {
+        // Même découpage calcul / exécution, mais avec un stockage compact
+        PackedMoves packed;
+        DirectionMoves directions(n, 'A', 'C', 'B');
+        perf.start();
         auto start_calc = chrono::high_resolution_clock::now();
-        if (choice == 1) hanoi_recursive(n, 'A', 'C', 'B');
-        else hanoi_iterative(n, 'A', 'C', 'B');
+        if (choice == 5) {
+            directions.resize((1ULL << n) - 1);
+            hanoi_simd(n, directions, threads, detect_simd_level());
+        }
+        else if (choice == 3 && mode == 3) fill_closed_form(packed, n, threads);
+        else if (choice == 3) fill_closed_form(directions, n, threads);
+        else if (mode == 3) fill_from_generator(packed, choice, n);
+        else fill_from_generator(directions, choice, n);
         auto end_calc = chrono::high_resolution_clock::now();
-        double time_calc = chrono::duration<double>(end_calc - start_calc).count();
+        r.perf_calc = perf.stop();
+        r.time_calc = chrono::duration<double>(end_calc - start_calc).count();
 
-        // 2. Timer pour simuler l’exécution (parcourir les mouvements)
-        long long execution_count = 0;
+        perf.start();
+        auto start_exec = chrono::high_resolution_clock::now();
+        if (mode == 3) replay = replay_moves(n, packed);
+        else replay = replay_moves(n, directions);
+        auto end_exec = chrono::high_resolution_clock::now();
+        r.perf_exec = perf.stop();
+        r.time_exec = chrono::duration<double>(end_exec - start_exec).count();
+        r.memory_bytes = (mode == 3 ? packed.memory_bytes() : directions.memory_bytes());
+    } else {
+        // Génération et exécution fusionnées : mémoire O(n) quel que soit n
+        moves.shrink_to_fit();  // libérer la mémoire d'un test précédent
+        r.threads = 1;
+        perf.start();
         auto start_exec = chrono::high_resolution_clock::now();
-        for (auto &m : moves) {
-            execution_count++;
+        if (choice == 1) {
+            RecursiveMoveStream stream(n, 'A', 'C', 'B');
+            replay = replay_moves(n, stream);
+        } else if (choice == 2) {
+            IterativeMoveStream stream(n, 'A', 'C', 'B');
+            replay = replay_moves(n, stream);
+        } else {
+            ClosedFormMoveStream stream(n, 'A', 'C', 'B');
+            replay = replay_moves(n, stream);
         }
         auto end_exec = chrono::high_resolution_clock::now();
-        double time_exec = chrono::duration<double>(end_exec - start_exec).count();
+        r.perf_exec = perf.stop();
+        r.time_exec = chrono::duration<double>(end_exec - start_exec).count();
+    }
+
+    // --- END TOTAL TIMER ---
+    auto end_total = chrono::high_resolution_clock::now();
+    r.time_total = chrono::duration<double>(end_total - start_total).count();
+    r.moves = replay.applied;
+    r.valid = replay.solved;
+    r.error_index = replay.error_index;
+    return r;
+}
+
+// Affiche la configuration après k mouvements sans rejouer la solution
+int print_state(int argc, char **argv) {
+    int n = argc > 2 ? atoi(argv[2]) : -1;
+    unsigned long long k = argc > 3 ? strtoull(argv[3], nullptr, 10) : 0;
+    if (argc != 4 || n < 0 || n > 62 || k > (1ULL << n) - 1) {
+        cerr << "Usage: " << argv[0] << " --state N K   (0 <= N <= 62, 0 <= K <= 2^N - 1)\n";
+        return 2;
+    }
+    vector<char> pegs = state_after(n, k);
+    cout << "State after move " << k << " of " << ((1ULL << n) - 1) << " (" << n << " disks):\n";
+    for (char p : {'A', 'B', 'C'}) {
+        cout << p << ":";
+        for (int d = n; d >= 1; d--) if (pegs[d - 1] == p) cout << " " << d;  // bas -> haut
+        cout << "\n";
+    }
+    if (k < (1ULL << n) - 1) {
+        Move m = move_at(n, k + 1);
+        cout << "Next move: " << m.first << " -> " << m.second << " (disk " << disk_at(k + 1) << ")\n";
+    }
+    return 0;
+}
+
+// Masques des piquets A, B, C (bit d-1 = disque d) d'une configuration
+void peg_masks(const Config &conf, uint64_t masks[3]) {
+    masks[0] = masks[1] = masks[2] = 0;
+    for (size_t d = 0; d < conf.size(); d++) masks[conf[d] - 'A'] |= 1ULL << d;
+}
+
+// Solution optimale écrite directement dans un fichier projeté :
+// ./hanoi --write FILE --n N [--encoding packed3|packed1] [--threads T]
+int write_move_file(int argc, char **argv) {
+    string path, encoding = "packed1";
+    int n = -1;
+    unsigned threads = default_thread_count();
+    bool ok = argc > 2;
+    for (int i = 1; i < argc && ok; i++) {
+        string a = argv[i];
+        bool has_value = i + 1 < argc;
+        if (a == "--write" && has_value) path = argv[++i];
+        else if (a == "--n" && has_value) n = atoi(argv[++i]);
+        else if (a == "--encoding" && has_value) encoding = argv[++i];
+        else if (a == "--threads" && has_value) threads = (unsigned)max(1, atoi(argv[++i]));
+        else ok = false;
+    }
+    if (!ok || path.empty() || n < 0 || n > MOVE_FILE_MAX_DISKS || (encoding != "packed3" && encoding != "packed1")) {
+        cerr << "Usage: " << argv[0] << " --write FILE --n N [--encoding packed3|packed1] [--threads T]   (0 <= N <= 63)\n";
+        return 2;
+    }
+    unsigned long long total = (1ULL << n) - 1;
+    uint32_t enc = encoding == "packed3" ? ENCODING_PACKED3 : ENCODING_DIRECTION;
+
+    auto start = chrono::high_resolution_clock::now();
+    MoveFileWriter file(path, n, enc, total);
+    if (!file.ok()) {
+        cerr << "Cannot write " << path << ": " << file.error() << "\n";
+        return 1;
+    }
+    if (enc == ENCODING_DIRECTION) {
+        hanoi_simd(n, file, threads, detect_simd_level());
+    } else {
+        parallel_move_slices(total, threads, PackedMoves::PER_WORD, [&](unsigned long long first, unsigned long long last) {
+            for (unsigned long long k = first; k <= last; k++) file.set_code(k - 1, encode_move(move_at(n, k)));
+        });
+    }
+    auto generated = chrono::high_resolution_clock::now();
+    if (!file.finish(threads)) {
+        cerr << "Cannot write " << path << ": " << file.error() << "\n";
+        return 1;
+    }
+    auto end = chrono::high_resolution_clock::now();
+
+    cout << "\n------ RESULTS ------\n";
+    cout << "File: " << path << " (" << encoding << ")\n";
+    cout << "Disks: " << n << endl;
+    cout << "Total moves: " << total << endl;
+    cout << "File size: " << (sizeof(MoveFileHeader) + move_file_words(enc, total) * 8) / (1024.0 * 1024.0) << " MB\n";
+    cout << "Time to generate into the mapping: " << chrono::duration<double>(generated - start).count() << " seconds\n";
+    cout << "Time to checksum and flush: " << chrono::duration<double>(end - generated).count() << " seconds\n";
+    cout << "---------------------\n";
+    return 0;
+}
 
-        // --- END TOTAL TIMER ---
-        auto end_total = chrono::high_resolution_clock::now();
-        double time_total = chrono::duration<double>(end_total - start_total).count();
+// Rejoue un fichier de mouvements sans le copier : ./hanoi --replay FILE [--no-verify]
+int replay_move_file(int argc, char **argv) {
+    bool verify = true;
+    vector<string> args;
+    for (int i = 2; i < argc; i++) {
+        if (string(argv[i]) == "--no-verify") verify = false;
+        else args.push_back(argv[i]);
+    }
+    if (args.size() != 1) {
+        cerr << "Usage: " << argv[0] << " --replay FILE [--no-verify]\n";
+        return 2;
+    }
+    string path = args[0], error;
+    MoveFile file;
+    if (!file.open(path, error)) {
+        cerr << "Cannot read " << path << ": " << error << "\n";
+        return 1;
+    }
+
+    auto t0 = chrono::high_resolution_clock::now();
+    bool checksum_ok = !verify || file.verify_checksum(default_thread_count());
+    auto t1 = chrono::high_resolution_clock::now();
+    string s = file.start(), t = file.target();
+    uint64_t start[3], target[3];
+    peg_masks(Config(s.begin(), s.end()), start);
+    peg_masks(Config(t.begin(), t.end()), target);
+    BitboardReplay board(start[0], start[1], start[2]);
+    for (Move m : file) {
+        if (!board.apply(m)) break;
+    }
+    auto t2 = chrono::high_resolution_clock::now();
+    ReplayResult replay = board.result();
+    bool reached = replay.error_index < 0 && board.peg(0) == target[0] && board.peg(1) == target[1] &&
+                   board.peg(2) == target[2];
+    double time_replay = chrono::duration<double>(t2 - t1).count();
+
+    cout << "\n------ RESULTS ------\n";
+    cout << "File: " << path << " (" << (file.encoding() == ENCODING_PACKED3 ? "packed3" : "packed1") << ", "
+         << file.file_bytes() / (1024.0 * 1024.0) << " MB)\n";
+    cout << "Disks: " << file.disks() << (file.optimal() ? " (optimal A -> C solution)" : "") << endl;
+    cout << "Total moves: " << file.size() << endl;
+    if (verify) {
+        cout << "Checksum: " << (checksum_ok ? "OK" : "MISMATCH") << " (" << chrono::duration<double>(t1 - t0).count()
+             << " seconds)\n";
+    }
+    cout << "Time to replay moves: " << time_replay << " seconds\n";
+    if (replay.error_index >= 0) cout << "Validation: ILLEGAL move at index " << replay.error_index << endl;
+    else cout << "Validation: " << (reached ? "OK, target configuration reached" : "FAILED, target not reached") << endl;
+    if (time_replay > 0) cout << "Replay rate: " << replay.applied / time_replay / 1e6 << " Mmoves/s\n";
+    cout << "---------------------\n";
+    return reached && checksum_ok ? 0 : 1;
+}
+
+// Plus court chemin entre deux configurations : ./hanoi --solve FROM [TO] [--print]
+int solve_config(int argc, char **argv) {
+    bool print = false;
+    string out;
+    vector<string> args;
+    for (int i = 2; i < argc; i++) {
+        if (string(argv[i]) == "--print") print = true;
+        else if (string(argv[i]) == "--write" && i + 1 < argc) out = argv[++i];
+        else args.push_back(argv[i]);
+    }
+    Config src, dst;
+    if (args.empty() || args.size() > 2 || !parse_config(args[0], src) ||
+        (args.size() == 2 && !parse_config(args[1], dst)) || src.size() > 63 ||
+        (args.size() == 2 && dst.size() != src.size())) {
+        cerr << "Usage: " << argv[0] << " --solve FROM [TO] [--print] [--write FILE]\n"
+                "  FROM, TO: peg of disk 1, disk 2, ... (e.g. ACBBA), at most 63 disks; TO defaults to all on C\n";
+        return 2;
+    }
+    if (args.size() == 1) dst.assign(src.size(), 'C');
+    int n = (int)src.size();
+
+    uint64_t start[3], target[3];
+    peg_masks(src, start);
+    peg_masks(dst, target);
+
+    auto t0 = chrono::high_resolution_clock::now();
+    ConfigMoveStream stream(src, dst);
+    auto t1 = chrono::high_resolution_clock::now();
+    unique_ptr<MoveFileWriter> file;
+    if (!out.empty()) {
+        file.reset(new MoveFileWriter(out, n, ENCODING_PACKED3, stream.size(), string(src.begin(), src.end()),
+                                      string(dst.begin(), dst.end())));
+        if (!file->ok()) {
+            cerr << "Cannot write " << out << ": " << file->error() << "\n";
+            return 1;
+        }
+    }
+    BitboardReplay board(start[0], start[1], start[2]);
+    Move m;
+    while (stream.next(m)) {
+        if (print) cout << m.first << " -> " << m.second << "\n";
+        if (file) file->push_back(m);
+        if (!board.apply(m)) break;
+    }
+    if (file && !file->finish(default_thread_count())) {
+        cerr << "Cannot write " << out << ": " << file->error() << "\n";
+        return 1;
+    }
+    auto t2 = chrono::high_resolution_clock::now();
+    ReplayResult replay = board.result();
+    bool reached = replay.error_index < 0 && board.peg(0) == target[0] && board.peg(1) == target[1] &&
+                   board.peg(2) == target[2];
+
+    cout << "\n------ RESULTS ------\n";
+    cout << "From: " << args[0] << "\nTo:   " << string(dst.begin(), dst.end()) << endl;
+    cout << "Disks: " << n << endl;
+    cout << "Total moves: " << stream.size() << " (" << stream.segments().size() << " tower segments)\n";
+    cout << "Time to plan: " << chrono::duration<double>(t1 - t0).count() << " seconds\n";
+    cout << "Time to generate and replay moves: " << chrono::duration<double>(t2 - t1).count() << " seconds\n";
+    if (file) cout << "Written to: " << out << endl;
+    if (replay.error_index >= 0) cout << "Validation: ILLEGAL move at index " << replay.error_index << endl;
+    else cout << "Validation: " << (reached ? "OK, target configuration reached" : "FAILED, target not reached") << endl;
+    cout << "---------------------\n";
+    return reached ? 0 : 1;
+}
+
+// Test différentiel : ./hanoi --diff --n N [--methods ...] [--threads T] [--sample K] [--chunk-disks M]
+//                     [--materialize-max N]
+const vector<string> diff_keys = {"closed", "rec", "iter", "parrec", "simd", "block", "guirec", "guiiter"};
+
+// Méthodes capables de produire n'importe quelle plage de la solution à n
+// disques (forme close, noyau SIMD, blocs) ; les autres ne sont testées sur
+// les n disques que lorsque la solution est matérialisée
+bool diff_any_range(int method) { return method == 0 || method == 4 || method == 5; }
+
+// Solution complète à n disques d'un générateur, par son vrai point d'entrée
+// et avec son nombre de threads
+void diff_generate(int method, int n, Move *out, unsigned threads) {
+    PointerSink sink{out};
+    if (method == 1) hanoi_recursive(n, 'A', 'C', 'B', sink);
+    else if (method == 2) hanoi_iterative(n, 'A', 'C', 'B', sink);
+    else if (method == 3) {
+        WorkStealingPool pool(threads);
+        hanoi_recursive_parallel(pool, n, 'A', 'C', 'B', out, default_cutoff_depth(threads));
+    } else if (method == 4) hanoi_simd(n, out, threads, detect_simd_level());
+    else if (method == 5) hanoi_block_expand(n, out, threads);
+    else if (method == 6) hanoiRec(n, 'A', 'C', 'B', sink);
+    else hanoiIter(n, 'A', 'C', 'B', sink);
+}
+
+// Tranche j de la solution d'un générateur (indice dans diff_keys), sans la
+// solution complète : la forme close, le noyau SIMD et les blocs produisent
+// la plage elle-même ; les autres générateurs produisent la tour de m disques
+// de la tranche avec les piquets renommés, le séparateur venant de la forme close.
+template <class Sink>
+void diff_chunk(int method, const ChunkPlan &plan, unsigned long long j, unsigned threads, Sink &sink) {
+    static const SimdLevel level = detect_simd_level();
+    thread_local vector<Move> scratch;
+    auto emit = [&](const Move *p, unsigned long long count, const char name[3]) {
+        for (unsigned long long i = 0; i < count; i++) sink(name[p[i].first - 'A'], name[p[i].second - 'A']);
+    };
+    const char same[3] = {'A', 'B', 'C'};
+    unsigned long long first = plan.first(j), count = plan.count(j);
+
+    if (method == 0) {
+        for (unsigned long long k = first + 1; k <= first + count; k++) {
+            Move m = move_at(plan.n, k);
+            sink(m.first, m.second);
+        }
+    } else if (method == 4) {
+        // the kernels index out[] by absolute move number (first: multiple of 64)
+        scratch.resize(count);
+        Move *out = scratch.data() - first;
+        if (level == SimdLevel::AVX512) hanoi_simd_avx512(plan.n, first, count, out);
+        else if (level == SimdLevel::AVX2) hanoi_simd_avx2(plan.n, first, count, out);
+        else hanoi_simd_scalar(plan.n, first, count, out);
+        emit(scratch.data(), count, same);
+    } else if (method == 5) {
+        // whole blocks covering the chunk (one block may hold several chunks)
+        int bm = block_disks(plan.n);
+        unsigned long long b0 = first >> bm, b1 = ((first + count - 1) >> bm) + 1;
+        scratch.resize((b1 - b0) << bm);
+        hanoi_block_range(plan.n, b0, b1, scratch.data());
+        emit(scratch.data() + (first - (b0 << bm)), count, same);
+    } else {
+        auto gen = [&](int m, char A, char C, char B, Sink &s) {
+            if (method == 1) hanoi_recursive(m, A, C, B, s);
+            else if (method == 2) hanoi_iterative(m, A, C, B, s);
+            else if (method == 6) hanoiRec(m, A, C, B, s);
+            else if (method == 7) hanoiIter(m, A, C, B, s);
+            else {
+                // the parallel split itself, on this thread's own one-queue pool
+                thread_local WorkStealingPool pool(1);
+                scratch.resize((1ULL << m) - 1);
+                hanoi_recursive_parallel(pool, m, A, C, B, scratch.data(), default_cutoff_depth(threads));
+                emit(scratch.data(), scratch.size(), same);
+            }
+        };
+        plan.run_tower(j, gen, sink);
+    }
+}
+
+int run_diff(int argc, char **argv) {
+    int n = -1, m = -1, materialize_max = 30;
+    unsigned threads = default_thread_count();
+    unsigned long long sample = 0;
+    vector<int> methods;
+    bool ok = true;
+    for (int i = 2; ok && i < argc; i++) {
+        string a = argv[i];
+        if (a == "--n" && i + 1 < argc) n = atoi(argv[++i]);
+        else if (a == "--chunk-disks" && i + 1 < argc) m = atoi(argv[++i]);
+        else if (a == "--threads" && i + 1 < argc) threads = (unsigned)atoi(argv[++i]);
+        else if (a == "--sample" && i + 1 < argc) sample = strtoull(argv[++i], nullptr, 10);
+        else if (a == "--materialize-max" && i + 1 < argc) materialize_max = atoi(argv[++i]);
+        else if (a == "--methods" && i + 1 < argc) {
+            string list = argv[++i], key;
+            for (size_t p = 0; ok && p <= list.size(); p++) {
+                if (p < list.size() && list[p] != ',') { key += list[p]; continue; }
+                auto it = find(diff_keys.begin(), diff_keys.end(), key);
+                if (it == diff_keys.end()) ok = false;
+                else if (it != diff_keys.begin()) methods.push_back((int)(it - diff_keys.begin()));
+                key.clear();
+            }
+        } else ok = false;
+    }
+    if (m < 0) m = max(16, n - 20);  // at most 2^20 chunks
+    if (!ok || n < 1 || n > 62 || threads == 0 || (m < 6 && m < n)) {
+        cerr << "Usage: " << argv[0] << " --diff --n N (1..62) [--methods rec,iter,parrec,simd,block,guirec,guiiter]\n"
+                "       [--threads T] [--sample K chunks] [--chunk-disks M (>= 6)] [--materialize-max N (30)]\n"
+                "  every method is compared with the closed form; up to --materialize-max disks each\n"
+                "  whole solution is generated, above only simd and block produce the real sequence\n";
+        return 2;
+    }
+    if (methods.empty()) for (int k = 1; k < (int)diff_keys.size(); k++) methods.push_back(k);
+
+    ChunkPlan plan(n, m);
+    vector<unsigned long long> selected;
+    if (sample == 0 || sample >= plan.chunks) {
+        for (unsigned long long j = 0; j < plan.chunks; j++) selected.push_back(j);
+    } else {
+        // evenly spread, first and last chunks included
+        for (unsigned long long i = 0; i < sample; i++) {
+            unsigned long long j = sample == 1 ? 0 : (unsigned long long)((long double)i * (plan.chunks - 1) / (sample - 1));
+            if (selected.empty() || selected.back() != j) selected.push_back(j);
+        }
+    }
+    bool full = selected.size() == plan.chunks;
+
+    // whole solutions, generated one method at a time into the same buffer
+    MoveArena arena;
+    bool materialize = n <= materialize_max;
+    if (materialize) {
+        string error;
+        if (!arena.allocate((1ULL << n) - 1, ArenaPages::Transparent, threads, error)) {
+            cerr << "Cannot allocate " << n << "-disk solutions (" << error << "), checking chunks only\n";
+            materialize = false;
+        }
+    }
+
+    cout << "\n------ DIFFERENTIAL TEST ------\n";
+    cout << "Disks: " << n << ", " << plan.chunks << " chunks of 2^" << plan.m << " moves, "
+         << (full ? "all checked" : to_string(selected.size()) + " checked (sampled)") << ", " << threads << " threads\n";
+    cout << (materialize ? "Whole solutions generated by each method, hashed by chunks\n"
+                         : "Chunks generated separately: rec, iter, parrec, guirec and guiiter only on " +
+                               to_string(plan.m) + "-disk sub-towers\n");
+    auto chunk_of = [&](int method) {
+        return [method, &plan, threads](unsigned long long j, auto &sink) { diff_chunk(method, plan, j, threads, sink); };
+    };
+    auto stored_chunk = [&](unsigned long long j, auto &sink) {
+        const Move *p = arena.data() + plan.first(j);
+        for (unsigned long long i = 0; i < plan.count(j); i++) sink(p[i].first, p[i].second);
+    };
+    auto whole = [&](int method) { return method != 0 && materialize; };
+    auto hash_all = [&](int method, unsigned long long &count, double &seconds) {
+        auto t0 = chrono::high_resolution_clock::now();
+        vector<uint64_t> h;
+        if (whole(method)) {
+            diff_generate(method, n, arena.data(), threads);
+            h = chunk_hashes(selected, threads, stored_chunk, count);
+        } else {
+            h = chunk_hashes(selected, threads, chunk_of(method), count);
+        }
+        seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - t0).count();
+        return h;
+    };
+    auto report = [&](int method, const vector<uint64_t> &h, unsigned long long count, double seconds) {
+        char hex[17];
+        snprintf(hex, sizeof hex, "%016llx", (unsigned long long)combine_chunks(plan, h));
+        cout << "  " << diff_keys[method] << string(9 - diff_keys[method].size(), ' ') << hex << "  " << count << " moves in "
+             << seconds << " s (" << (seconds > 0 ? count / seconds / 1e6 : 0) << " Mmoves/s)";
+    };
+
+    unsigned long long count;
+    double seconds;
+    vector<uint64_t> reference = hash_all(0, count, seconds);
+    report(0, reference, count, seconds);
+    cout << "  reference\n";
+    int failures = 0;
+    string partial;  // methods only checked on sub-towers
+    for (int method : methods) {
+        vector<uint64_t> h = hash_all(method, count, seconds);
+        report(method, h, count, seconds);
+        size_t i = 0;
+        while (i < h.size() && h[i] == reference[i]) i++;
+        if (i == h.size()) {
+            if (whole(method) || diff_any_range(method)) {
+                cout << "  OK\n";
+            } else {
+                cout << "  OK on " << plan.m << "-disk sub-towers only\n";
+                partial += (partial.empty() ? "" : ", ") + diff_keys[method];
+            }
+            continue;
+        }
+        failures++;
+        Move expected, got;
+        long long at = whole(method) ? first_difference(plan, selected[i], chunk_of(0), stored_chunk, expected, got)
+                                     : first_difference(plan, selected[i], chunk_of(0), chunk_of(method), expected, got);
+        cout << "  MISMATCH\n    first difference at move " << at + 1 << " (index " << at << "): expected "
+             << expected.first << " -> " << expected.second << ", got " << got.first << " -> " << got.second << "\n";
+    }
+    cout << (full ? "Whole sequences" : "Sampled chunks") << ": " << (failures ? "DIFFERENT" : "identical");
+    if (!failures && !partial.empty()) cout << " (" << partial << ": sub-towers only, separators not tested)";
+    cout << endl;
+    cout << "-------------------------------\n";
+    return failures ? 1 : 0;
+}
+
+// Serveur de requêtes : ./hanoi --serve SOCKET | --query (stdin) [--threads T] [--cache N]
+static atomic<bool> stop_server(false);
+
+int run_query_server(int argc, char **argv) {
+    bool batch = string(argv[1]) == "--query";
+    string socket_path;
+    unsigned threads = default_thread_count();
+    size_t cache_entries = 1024;
+    int i = 2;
+    if (!batch && argc > 2) socket_path = argv[i++];
+    // an option in place of the path (--serve --threads 4) is a usage error
+    bool ok = batch || (!socket_path.empty() && socket_path.compare(0, 2, "--") != 0);
+    for (; ok && i < argc; i++) {
+        string a = argv[i];
+        if (a == "--threads" && i + 1 < argc) threads = (unsigned)atoi(argv[++i]);
+        else if (a == "--cache" && i + 1 < argc) cache_entries = (size_t)atol(argv[++i]);
+        else ok = false;
+    }
+    if (!ok || threads == 0) {
+        cerr << "Usage: " << argv[0] << " --serve SOCKET [--threads T] [--cache N]\n"
+                "   or: " << argv[0] << " --query [--threads T] [--cache N] < requests\n";
+        return 2;
+    }
+    QueryEngine engine(cache_entries);
+    QueryPool pool(threads);
+
+    if (batch) {
+        // same batches as a pipelined client: up to 4096 lines per round
+        vector<string> lines, answers;
+        string line;
+        bool more = true;
+        while (more) {
+            lines.clear();
+            while (lines.size() < 4096 && (more = (bool)getline(cin, line))) {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (line == "QUIT") { more = false; break; }
+                lines.push_back(line);
+            }
+            pool.run(engine, lines, answers);
+            for (const string &a : answers) cout << a << '\n';
+        }
+        cout.flush();
+        return 0;
+    }
+
+    signal(SIGINT, [](int) { stop_server = true; });
+    signal(SIGTERM, [](int) { stop_server = true; });
+    cerr << "Listening on " << socket_path << " (" << threads << " workers, cache " << cache_entries << " plans)\n";
+    string error;
+    if (!serve_unix_socket(socket_path, engine, pool, stop_server, error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Générateur de charge : ./hanoi --load SOCKET [--connections C] [--requests R] [--pipeline P] [--n N]
+int run_query_load(int argc, char **argv) {
+    unsigned connections = 4, pipeline = 64;
+    unsigned long long requests = 100000;
+    int n = 20;
+    bool ok = argc > 2 && string(argv[2]).compare(0, 2, "--") != 0;
+    for (int i = 3; ok && i < argc; i++) {
+        string a = argv[i];
+        if (a == "--connections" && i + 1 < argc) connections = (unsigned)atoi(argv[++i]);
+        else if (a == "--requests" && i + 1 < argc) requests = strtoull(argv[++i], nullptr, 10);
+        else if (a == "--pipeline" && i + 1 < argc) pipeline = (unsigned)atoi(argv[++i]);
+        else if (a == "--n" && i + 1 < argc) n = atoi(argv[++i]);
+        else ok = false;
+    }
+    if (!ok || connections == 0 || pipeline == 0 || n < 1 || n > 63) {
+        cerr << "Usage: " << argv[0] << " --load SOCKET [--connections C] [--requests R per connection] "
+                "[--pipeline P] [--n N (1..63)]\n";
+        return 2;
+    }
+    LoadResult r;
+    string error;
+    bool done = run_load(argv[2], connections, requests, pipeline, n, r, error);
+    if (!done && r.requests == 0) {
+        cerr << error << "\n";
+        return 1;
+    }
+    vector<double> &lat = r.latency_us;
+    sort(lat.begin(), lat.end());
+    auto pct = [&](double p) { return lat.empty() ? 0.0 : lat[(size_t)(p * (lat.size() - 1))]; };
+    cout << "\n------ LOAD ------\n";
+    cout << "Connections: " << connections << ", pipeline: " << pipeline << ", n = " << n << endl;
+    cout << "Requests: " << r.requests << " (" << r.errors << " errors) in " << r.seconds << " seconds\n";
+    cout << "Throughput: " << (r.seconds > 0 ? r.requests / r.seconds : 0) << " requests/s\n";
+    cout << "Latency (us): p50 " << pct(0.5) << ", p99 " << pct(0.99) << ", max " << (lat.empty() ? 0 : lat.back()) << endl;
+    if (!done) cout << "Stopped early: " << error << endl;
+    cout << "------------------\n";
+    return done && r.errors == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    // Depuis une configuration quelconque : ./hanoi --solve FROM [TO]
+    if (argc > 1 && string(argv[1]) == "--solve") return solve_config(argc, argv);
+    // Fichiers de mouvements projetés en mémoire
+    if (argc > 1 && string(argv[1]) == "--write") return write_move_file(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--replay") return replay_move_file(argc, argv);
+    // État après le mouvement k : ./hanoi --state N K
+    if (argc > 1 && string(argv[1]) == "--state") return print_state(argc, argv);
+
+    // Comparaison des générateurs par hachage de tranches
+    if (argc > 1 && string(argv[1]) == "--diff") return run_diff(argc, argv);
+    // Requêtes (mouvement k, état, chemin entre configurations)
+    if (argc > 1 && (string(argv[1]) == "--serve" || string(argv[1]) == "--query")) return run_query_server(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--load") return run_query_load(argc, argv);
+
+    // Flux 128 bits avec points de contrôle : ./hanoi --big [options]
+    if (argc > 1 && string(argv[1]) == "--big") return run_big_stream(argc, argv);
+
+    // Mode benchmark non interactif : ./hanoi --bench [options]
+    if (argc > 1) {
+        BenchOptions opt;
+        if (string(argv[1]) != "--bench" || !parse_bench_args(argc, argv, method_keys, mode_keys, opt)) {
+            cerr << "Usage: " << argv[0] << " --bench [--n 10-24[:step]|a,b,c] [--methods rec,iter,closed,parrec,simd,fs,block]\n"
+                    "       [--mode vector,stream,packed3,packed1,count,checksum,file,callback] [--warmup W] [--reps N] [--threads T] [--pegs P]\n"
+                    "       [--buffer vector|thp|hugetlb] [--format table|csv|json] [--out FILE]\n"
+                    "   or: " << argv[0] << " --big --n N [--from K] [--to K] [--checkpoint FILE] [--every SEC]\n"
+                    "       [--max-seconds SEC]\n"
+                    "   or: " << argv[0] << " --big --resume FILE [--checkpoint FILE]\n"
+                    "   or: " << argv[0] << " --state N K\n"
+                    "   or: " << argv[0] << " --solve FROM [TO] [--print] [--write FILE]\n"
+                    "   or: " << argv[0] << " --write FILE --n N [--encoding packed3|packed1] [--threads T]\n"
+                    "   or: " << argv[0] << " --replay FILE [--no-verify]\n"
+                    "   or: " << argv[0] << " --diff --n N [--methods ...] [--threads T] [--sample K] [--chunk-disks M]\n"
+                    "       [--materialize-max N]\n"
+                    "   or: " << argv[0] << " --serve SOCKET | --query [--threads T] [--cache N]\n"
+                    "   or: " << argv[0] << " --load SOCKET [--connections C] [--requests R] [--pipeline P] [--n N]\n";
+            return 2;
+        }
+        unsigned threads = opt.threads ? opt.threads : default_thread_count();
+        int pegs = opt.pegs;
+        string buffer = opt.buffer;
+        return run_benchmark(opt, method_keys, mode_keys,
+                             [pegs, buffer](int choice, int mode, int n) { return unsupported(choice, mode, n, pegs, buffer); },
+                             [threads, pegs, buffer](int choice, int mode, int n) {
+                                 return run_solver(choice, mode, n, threads, pegs, buffer);
+                             });
+    }
+
+    while (true) {
+        int n, choice;
+        cout << "Enter number of disks: ";
+        if (!(cin >> n)) {
+            if (cin.eof()) break;
+            cin.clear();
+            cin.ignore(1000, '\n');
+            cout << "Invalid number. Try again.\n";
+            continue;
+        }
+
+        cout << "\nChoose method:\n1 - Recursive\n2 - Iterative\n3 - Closed-form (multi-threaded)\n"
+                "4 - Recursive (parallel, work-stealing)\n5 - SIMD batch kernel (multi-threaded)\n"
+                "6 - Frame-Stewart (k pegs)\n7 - Block expansion (16-disk tables, multi-threaded)\nYour choice: ";
+        cin >> choice;
+
+        if (choice < 1 || choice > 7) {
+            cout << "Invalid choice. Try again.\n";
+            continue;
+        }
+
+        int pegs = 3;
+        if (choice == 6) {
+            cout << "Number of pegs (3-" << MAX_PEGS << "): ";
+            cin >> pegs;
+        }
+
+        int mode;
+        cout << "\nChoose mode:\n1 - Materialize (store all moves)\n2 - Stream (consume moves as they are produced)\n"
+                "3 - Packed (3 bits per move)\n4 - Packed (1 direction bit per move)\n"
+                "5 - Count only (no storage)\n6 - Checksum only\n7 - Write to a move file\n"
+                "8 - Callback (moves per source peg)\nYour choice: ";
+        cin >> mode;
+
+        if (mode < 1 || mode > 8) {
+            cout << "Invalid choice. Try again.\n";
+            continue;
+        }
+        if (const char *why = unsupported(choice, mode, n, pegs)) {
+            cout << "Not available: " << why << ". Try again.\n";
+            continue;
+        }
+
+        RunResult r = run_solver(choice, mode, n, default_thread_count(), pegs);
 
         // Affichage des résultats
         cout << "\n------ RESULTS ------\n";
-        cout << "Method: " << (choice == 1 ? "Recursive" : "Iterative") << endl;
+        const char *method_names[] = {"Recursive", "Iterative", "Closed-form", "Recursive (parallel)", "SIMD", "Frame-Stewart",
+                                      "Block expansion"};
+        cout << "Method: " << method_names[choice - 1] << endl;
+        if (choice == 6) cout << "Pegs: " << pegs << endl;
+        if (choice == 5) cout << "SIMD level: " << simd_level_name(detect_simd_level()) << endl;
+        if (r.threads > 1) cout << "Threads: " << r.threads << endl;
+        const char *mode_names[] = {"Materialized", "Streamed", "Packed (3 bits)", "Packed (1 bit)",
+                                    "Count sink", "Checksum sink", "Move file sink", "Callback sink"};
+        bool fused = (mode == 2 || mode >= 5);  // generation and consumption in one pass
+        cout << "Mode: " << mode_names[mode - 1] << endl;
         cout << "Disks: " << n << endl;
-        cout << "Total moves: " << moves.size() << endl;
-        cout << "Time to calculate solution: " << time_calc << " seconds\n";
-        cout << "Time to reach final solution: " << time_exec << " seconds\n";
-        cout << "Total time from start to finish: " << time_total << " seconds\n";
+        cout << "Total moves: " << r.moves << endl;
+        if (!fused) {
+            cout << "Time to calculate solution: " << r.time_calc << " seconds\n";
+            cout << "Time to reach final solution: " << r.time_exec << " seconds\n";
+            cout << "Memory for stored moves: " << r.memory_bytes / (1024.0 * 1024.0) << " MB\n";
+        } else {
+            cout << "Time to generate and consume moves: " << r.time_exec << " seconds\n";
+        }
+        cout << "Total time from start to finish: " << r.time_total << " seconds\n";
+        if (r.error_index >= 0) cout << "Validation: ILLEGAL move at index " << r.error_index << endl;
+        else if (mode >= 5) {
+            const char *checked[] = {"move count matches (contents not checked)", "checksum matches the optimal solution",
+                                     "move file replays to all disks on C", "moves per source peg match the optimal solution"};
+            cout << "Validation: " << (r.valid ? string("OK, ") + checked[mode - 5] : string("FAILED")) << endl;
+        }
+        else cout << "Validation: " << (r.valid ? "OK, all disks on " : "FAILED, final state is not solved")
+                  << (r.valid ? string(1, char('A' + r.pegs - 1)) : "") << endl;
+        if (r.time_exec > 0) cout << "Replay rate: " << r.moves / r.time_exec / 1e6 << " Mmoves/s\n";
+        if (r.time_calc > 0) cout << "Generation rate: " << r.moves / r.time_calc / 1e6 << " Mmoves/s\n";
+        if (r.perf_exec.value[PERF_CYCLES] < 0) cout << "Hardware counters: unavailable (" << PerfCounters().error() << ")\n";
+        if (!fused) print_perf(cout, "generation", r.perf_calc);
+        print_perf(cout, fused ? "generate and consume" : "replay", r.perf_exec);
+        if (choice == 4) {
+            // Comparaison avec les versions série sur la même taille
+            double t_rec = time_serial(1, n), t_iter = time_serial(2, n);
+            cout << "Speedup vs Recursive (serial, " << t_rec << " s): " << t_rec / r.time_calc << "x\n";
+            cout << "Speedup vs Iterative (serial, " << t_iter << " s): " << t_iter / r.time_calc << "x\n";
+        }
         cout << "---------------------\n";
 
         char again;
@@ -0,0 +1,179 @@
+// move_arena.hpp — tampon de mouvements pré-dimensionné (pages énormes, NUMA)
+// Exactement 2^n - 1 mouvements, arrondis à des pages de 2 Mo : ni
+// réallocation ni copie, et aucune initialisation par un seul thread.
+// Pages : transparentes (madvise MADV_HUGEPAGE) ou explicites (MAP_HUGETLB,
+// qui demande des pages réservées dans /proc/sys/vm/nr_hugepages ; sinon
+// repli sur les pages transparentes). Le premier accès à chaque page est
+// fait en parallèle, tranche t par un thread placé sur le nœud NUMA
+// t * nœuds / threads : les pages sont réparties entre les nœuds.
+// kind() lit ensuite /proc/self/smaps : "4k" si le noyau n'a fourni aucune
+// page transparente (THP désactivées, madvise refusé, mémoire fragmentée).
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include "hanoi_stream.hpp"
+
+const size_t HUGE_PAGE_BYTES = 2u << 20;
+
+enum class ArenaPages { Transparent, Explicit };
+
+// CPUs of each NUMA node (one node with every CPU when sysfs has no topology)
+inline std::vector<std::vector<int>> numa_node_cpus() {
+    std::vector<std::vector<int>> nodes;
+    std::vector<int> ids;
+    if (DIR *dir = opendir("/sys/devices/system/node")) {
+        while (dirent *e = readdir(dir)) {
+            int id;
+            char rest;
+            if (std::sscanf(e->d_name, "node%d%c", &id, &rest) == 1) ids.push_back(id);
+        }
+        closedir(dir);
+    }
+    std::sort(ids.begin(), ids.end());
+    for (int node : ids) {
+        std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+        FILE *f = std::fopen(path.c_str(), "r");
+        if (!f) continue;
+        std::vector<int> cpus;
+        int a, b;
+        char sep;
+        while (std::fscanf(f, "%d", &a) == 1) {
+            b = a;
+            if (std::fscanf(f, "%c", &sep) == 1 && sep == '-') {
+                if (std::fscanf(f, "%d", &b) != 1) break;
+                if (std::fscanf(f, "%c", &sep) != 1) sep = '\n';
+            }
+            for (int c = a; c <= b; c++) cpus.push_back(c);
+            if (sep != ',') break;
+        }
+        std::fclose(f);
+        if (!cpus.empty()) nodes.push_back(cpus);
+    }
+    if (nodes.empty()) {
+        unsigned n = std::thread::hardware_concurrency();
+        nodes.push_back({});
+        for (unsigned c = 0; c < (n ? n : 1); c++) nodes[0].push_back((int)c);
+    }
+    return nodes;
+}
+
+class MoveArena {
+public:
+    MoveArena() = default;
+    ~MoveArena() { release(); }
+    MoveArena(const MoveArena &) = delete;
+    MoveArena &operator=(const MoveArena &) = delete;
+
+    // Maps `count` moves and places their pages with `threads` threads
+    bool allocate(size_t count, ArenaPages pages, unsigned threads, std::string &error) {
+        release();
+        mapped = (count * sizeof(Move) + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+        if (mapped == 0) mapped = HUGE_PAGE_BYTES;
+        void *p = MAP_FAILED;
+        explicit_pages = false;
+        if (pages == ArenaPages::Explicit) {
+            p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            explicit_pages = p != MAP_FAILED;
+        }
+        if (p == MAP_FAILED) {
+            // one extra huge page of slack so the arena starts on a 2 MB boundary
+            p = mmap(nullptr, mapped + HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                error = std::string("mmap failed: ") + std::strerror(errno);
+                mapped = 0;
+                return false;
+            }
+            char *raw = (char *)p;
+            char *aligned = (char *)(((uintptr_t)raw + HUGE_PAGE_BYTES - 1) & ~(uintptr_t)(HUGE_PAGE_BYTES - 1));
+            if (aligned > raw) munmap(raw, aligned - raw);
+            if (aligned < raw + HUGE_PAGE_BYTES) munmap(aligned + mapped, raw + HUGE_PAGE_BYTES - aligned);
+            p = aligned;
+            madvise(p, mapped, MADV_HUGEPAGE);  // may fail or be ignored: checked below
+        }
+        base = (Move *)p;
+        used = count;
+        first_touch(threads ? threads : 1);
+        huge_bytes = explicit_pages ? mapped : anon_huge_bytes();
+        return true;
+    }
+
+    void release() {
+        if (base) munmap(base, mapped);
+        base = nullptr;
+        mapped = used = huge_bytes = 0;
+    }
+
+    Move *data() { return base; }
+    size_t size() const { return used; }
+    Move *begin() { return base; }
+    Move *end() { return base + used; }
+    const Move *begin() const { return base; }
+    const Move *end() const { return base + used; }
+    size_t bytes() const { return mapped; }
+    // "hugetlb", "thp", or "4k" when no transparent huge page backs the arena
+    const char *kind() const { return explicit_pages ? "hugetlb" : huge_bytes ? "thp" : "4k"; }
+    int nodes() const { return node_count; }
+
+private:
+    // One slice of whole huge pages per thread; thread t is pinned to a node
+    void first_touch(unsigned threads) {
+        std::vector<std::vector<int>> nodes = numa_node_cpus();
+        node_count = (int)nodes.size();
+        size_t pages = mapped / HUGE_PAGE_BYTES;
+        if (threads > pages) threads = (unsigned)pages;
+        size_t per = (pages + threads - 1) / threads;
+        auto touch = [this, per, pages, threads, &nodes](unsigned t) {
+            const std::vector<int> &cpus = nodes[(size_t)t * nodes.size() / threads];
+            if (nodes.size() > 1) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (int c : cpus) if (c < CPU_SETSIZE) CPU_SET(c, &set);
+                pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+            }
+            char *p = (char *)base;
+            size_t end = std::min(pages, (t + 1) * per) * HUGE_PAGE_BYTES;
+            for (size_t off = t * per * HUGE_PAGE_BYTES; off < end; off += 4096) p[off] = 0;
+        };
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; t++) pool.emplace_back(touch, t);
+        if (nodes.size() > 1) {
+            // the caller keeps its affinity
+            std::thread first(touch, 0u);
+            first.join();
+        } else {
+            touch(0);
+        }
+        for (auto &th : pool) th.join();
+    }
+
+    // AnonHugePages of the mappings overlapping the arena (/proc/self/smaps)
+    size_t anon_huge_bytes() const {
+        FILE *f = std::fopen("/proc/self/smaps", "r");
+        if (!f) return 0;
+        uintptr_t lo = (uintptr_t)base, hi = lo + mapped, a, b;
+        bool inside = false;
+        size_t total = 0, kb;
+        char line[512];
+        while (std::fgets(line, sizeof line, f)) {
+            if (std::sscanf(line, "%lx-%lx ", &a, &b) == 2) inside = a < hi && b > lo;
+            else if (inside && std::sscanf(line, "AnonHugePages: %zu kB", &kb) == 1) total += kb << 10;
+        }
+        std::fclose(f);
+        return total;
+    }
+
+    Move *base = nullptr;
+    size_t mapped = 0, used = 0, huge_bytes = 0;
+    bool explicit_pages = false;
+    int node_count = 1;
+};
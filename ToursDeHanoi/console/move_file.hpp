@@ -0,0 +1,236 @@
+// move_file.hpp — fichier binaire de mouvements, écrit et lu via mmap
+// Format (little-endian) :
+//   en-tête de 192 octets (MoveFileHeader), puis les mots de 64 bits des
+//   mouvements, codés comme PackedMoves (3 bits, 21 par mot) ou comme
+//   DirectionMoves (1 bit par mouvement, solution optimale A -> C seulement).
+// La somme de contrôle porte sur les mots de données ; elle est combinable
+// (somme de mix(mot, indice)), donc calculée en parallèle par tranches.
+// Le fichier est projeté en entier : le noyau pagine, la taille n'est pas
+// limitée par la RAM. L'écriture passe par FILE.tmp puis rename.
+#pragma once
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "closed_form.hpp"
+#include "packed_moves.hpp"
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "move files are little-endian");
+
+enum MoveEncoding : uint32_t { ENCODING_PACKED3 = 0, ENCODING_DIRECTION = 1 };
+
+const uint32_t MOVE_FILE_VERSION = 1;
+const uint32_t MOVE_FILE_OPTIMAL = 1;  // flag: optimal A -> C solution of `disks` disks
+const int MOVE_FILE_MAX_DISKS = 63;
+
+struct MoveFileHeader {
+    char magic[8];      // "HANOIMV\n"
+    uint32_t version;
+    uint32_t encoding;  // MoveEncoding
+    uint32_t disks;
+    uint32_t flags;
+    uint64_t moves;
+    uint64_t words;     // data words after the header
+    uint64_t checksum;  // move_file_checksum of the data words
+    char reserved[16];
+    char start[64];     // peg of disk d at start[d - 1] ('A', 'B' or 'C')
+    char target[64];    // expected final configuration
+};
+static_assert(sizeof(MoveFileHeader) == 192, "header layout");
+
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27; x *= 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Sum over the words of mix(word, index): slices can be added in any order
+inline uint64_t move_file_checksum(const uint64_t *data, uint64_t words, unsigned threads) {
+    std::atomic<uint64_t> sum(0);
+    parallel_move_slices(words, threads, 4096, [&](unsigned long long first, unsigned long long last) {
+        uint64_t s = 0;
+        for (uint64_t i = first - 1; i < last; i++) s += mix64(data[i] + i * 0x9E3779B97F4A7C15ULL);
+        sum += s;
+    });
+    return sum.load();
+}
+
+inline uint64_t move_file_words(uint32_t encoding, uint64_t moves) {
+    return encoding == ENCODING_DIRECTION ? (moves + 63) / 64 : (moves + PackedMoves::PER_WORD - 1) / PackedMoves::PER_WORD;
+}
+
+// Writer: the file is sized and mapped up front, generators fill the words
+// in place (set / set_code / or_bits32 by index, or push_back in order).
+class MoveFileWriter {
+public:
+    // `start`/`target` default to all disks on A / on C
+    MoveFileWriter(const std::string &path, int n, uint32_t encoding, uint64_t moves,
+                   const std::string &start = "", const std::string &target = "")
+        : path(path), tmp(path + ".tmp"), encoding(encoding), count(moves) {
+        if (n < 0 || n > MOVE_FILE_MAX_DISKS) { err = "number of disks must be between 0 and 63"; return; }
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "HANOIMV\n", 8);
+        header.version = MOVE_FILE_VERSION;
+        header.encoding = encoding;
+        header.disks = (uint32_t)n;
+        header.moves = moves;
+        header.words = move_file_words(encoding, moves);
+        for (int d = 0; d < n; d++) {
+            header.start[d] = d < (int)start.size() ? start[d] : 'A';
+            header.target[d] = d < (int)target.size() ? target[d] : 'C';
+        }
+        if (start.find_first_not_of('A') == std::string::npos && target.find_first_not_of('C') == std::string::npos &&
+            n < 64 && moves == (1ULL << n) - 1)
+            header.flags |= MOVE_FILE_OPTIMAL;
+        if (encoding == ENCODING_DIRECTION && !(header.flags & MOVE_FILE_OPTIMAL)) {
+            err = "direction encoding only stores the optimal A -> C solution";
+            return;
+        }
+        direction_pairs(n, 'A', 'C', 'B', pairs);
+
+        fd = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) { err = "cannot create " + tmp + ": " + std::strerror(errno); return; }
+        size_t bytes = sizeof(MoveFileHeader) + header.words * 8;
+        if (ftruncate(fd, (off_t)bytes) != 0) { err = std::string("cannot size file: ") + std::strerror(errno); return; }
+        void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) { err = std::string("mmap failed: ") + std::strerror(errno); return; }
+        base = (char *)p;
+        mapped = bytes;
+        words = (uint64_t *)(base + sizeof(MoveFileHeader));  // ftruncate zero-fills
+        madvise(base, mapped, MADV_SEQUENTIAL);
+    }
+
+    ~MoveFileWriter() {
+        if (base) munmap(base, mapped);
+        if (fd >= 0) close(fd);
+        if (!done) ::unlink(tmp.c_str());
+    }
+
+    MoveFileWriter(const MoveFileWriter &) = delete;
+    MoveFileWriter &operator=(const MoveFileWriter &) = delete;
+
+    bool ok() const { return base != nullptr && err.empty(); }
+    const std::string &error() const { return err; }
+    size_t size() const { return count; }
+
+    // Same contracts as PackedMoves / DirectionMoves; threads must fill
+    // disjoint ranges of whole words (21 moves packed, 64 moves direction)
+    void set_code(size_t i, unsigned code) { words[i / PackedMoves::PER_WORD] |= (uint64_t)code << (3 * (i % PackedMoves::PER_WORD)); }
+    void or_bits32(size_t i, uint32_t mask) { words[i / 64] |= (uint64_t)mask << (i % 64); }
+    void set(size_t i, Move m) {
+        if (encoding == ENCODING_PACKED3) set_code(i, encode_move(m));
+        else if (m.first != pairs[(i + 1) % 3].first) words[i / 64] |= 1ULL << (i % 64);
+    }
+    void push_back(Move m) {
+        if (cursor < count) set(cursor++, m);
+    }
+
+    // Checksum, header, flush to disk, then rename FILE.tmp -> FILE
+    bool finish(unsigned threads) {
+        if (!ok()) return false;
+        header.checksum = move_file_checksum(words, header.words, threads);
+        std::memcpy(base, &header, sizeof(header));
+        if (msync(base, mapped, MS_SYNC) != 0) { err = std::string("msync failed: ") + std::strerror(errno); return false; }
+        munmap(base, mapped);
+        base = nullptr;
+        close(fd);
+        fd = -1;
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) { err = "cannot rename to " + path; return false; }
+        done = true;
+        return true;
+    }
+
+private:
+    std::string path, tmp, err;
+    uint32_t encoding;
+    uint64_t count, cursor = 0;
+    MoveFileHeader header;
+    Move pairs[3];
+    int fd = -1;
+    char *base = nullptr;
+    size_t mapped = 0;
+    uint64_t *words = nullptr;
+    bool done = false;
+};
+
+// Zero-copy reader: moves are decoded straight from the mapping
+class MoveFile {
+public:
+    MoveFile() = default;
+    ~MoveFile() { if (base) munmap(base, mapped); }
+    MoveFile(const MoveFile &) = delete;
+    MoveFile &operator=(const MoveFile &) = delete;
+
+    // Maps and checks the header and the file size (not the checksum)
+    bool open(const std::string &path, std::string &error) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) { error = "cannot open " + path + ": " + std::strerror(errno); return false; }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(MoveFileHeader)) {
+            close(fd);
+            error = "file too small";
+            return false;
+        }
+        void *p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);  // the mapping keeps the file open
+        if (p == MAP_FAILED) { error = std::string("mmap failed: ") + std::strerror(errno); return false; }
+        base = (char *)p;
+        mapped = (size_t)st.st_size;
+        std::memcpy(&header, base, sizeof(header));
+
+        if (std::memcmp(header.magic, "HANOIMV\n", 8) != 0) { error = "not a move file"; return false; }
+        if (header.version != MOVE_FILE_VERSION) { error = "unsupported version"; return false; }
+        if (header.encoding > ENCODING_DIRECTION) { error = "unknown encoding"; return false; }
+        if (header.disks > (uint32_t)MOVE_FILE_MAX_DISKS) { error = "bad disk count"; return false; }
+        if (header.encoding == ENCODING_DIRECTION && !(header.flags & MOVE_FILE_OPTIMAL)) { error = "bad flags"; return false; }
+        if (header.words > mapped / 8 || header.words != move_file_words(header.encoding, header.moves) ||
+            mapped != sizeof(MoveFileHeader) + header.words * 8) {
+            error = "file size does not match move count";
+            return false;
+        }
+        auto bad_peg = [](char c) { return c != 'A' && c != 'B' && c != 'C'; };
+        for (uint32_t d = 0; d < header.disks; d++) {
+            if (bad_peg(header.start[d]) || bad_peg(header.target[d])) { error = "bad start or target configuration"; return false; }
+        }
+        words = (const uint64_t *)(base + sizeof(MoveFileHeader));
+        madvise(base, mapped, MADV_SEQUENTIAL);
+        direction_pairs((int)header.disks, 'A', 'C', 'B', pairs);
+        return true;
+    }
+
+    bool verify_checksum(unsigned threads) const { return move_file_checksum(words, header.words, threads) == header.checksum; }
+
+    int disks() const { return (int)header.disks; }
+    size_t size() const { return header.moves; }
+    uint32_t encoding() const { return header.encoding; }
+    bool optimal() const { return header.flags & MOVE_FILE_OPTIMAL; }
+    size_t file_bytes() const { return mapped; }
+    std::string start() const { return std::string(header.start, header.disks); }
+    std::string target() const { return std::string(header.target, header.disks); }
+
+    Move operator[](size_t i) const {
+        if (header.encoding == ENCODING_PACKED3) {
+            unsigned code = (words[i / PackedMoves::PER_WORD] >> (3 * (i % PackedMoves::PER_WORD))) & 7;
+            return code < 6 ? decode_move(code) : Move{'?', '?'};  // corrupted: rejected by the replay
+        }
+        const Move &p = pairs[(i + 1) % 3];
+        bool reversed = (words[i / 64] >> (i % 64)) & 1;
+        return reversed ? Move{p.second, p.first} : p;
+    }
+
+    PackedIterator<MoveFile> begin() const { return PackedIterator<MoveFile>(this, 0); }
+    PackedIterator<MoveFile> end() const { return PackedIterator<MoveFile>(this, header.moves); }
+
+private:
+    MoveFileHeader header;
+    Move pairs[3];
+    char *base = nullptr;
+    size_t mapped = 0;
+    const uint64_t *words = nullptr;
+};
@@ -0,0 +1,48 @@
+// move_sinks.hpp — destinations des mouvements pour les générateurs templates
+// Un sink est un objet appelable sink(from, to) ; le générateur est
+// instancié pour chaque type de sink, donc la boucle est spécialisée et
+// l'appel inliné. Comptage, somme de contrôle et callback n'allouent rien.
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "hanoi_stream.hpp"
+#include "packed_moves.hpp"
+
+// Number of moves only
+struct CountSink {
+    unsigned long long count = 0;
+    void operator()(char, char) { ++count; }
+};
+
+// FNV-1a over the 3-bit move codes (order dependent)
+struct ChecksumSink {
+    unsigned long long count = 0;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    void operator()(char from, char to) {
+        hash = (hash ^ encode_move({from, to})) * 0x100000001B3ULL;
+        ++count;
+    }
+};
+
+// Appends to a vector, reserved up front when the size is known
+struct VectorSink {
+    std::vector<Move> &out;
+    VectorSink(std::vector<Move> &v, size_t expected = 0) : out(v) {
+        if (expected) out.reserve(out.size() + expected);
+    }
+    void operator()(char from, char to) { out.push_back({from, to}); }
+};
+
+// Writes into a buffer already sized for all the moves (MoveArena)
+struct PointerSink {
+    Move *out;
+    void operator()(char from, char to) { *out++ = {from, to}; }
+};
+
+// Any buffer with push_back(Move): PackedMoves, DirectionMoves, MoveFileWriter
+template <class Buffer>
+struct BufferSink {
+    Buffer &out;
+    explicit BufferSink(Buffer &b) : out(b) {}
+    void operator()(char from, char to) { out.push_back({from, to}); }
+};
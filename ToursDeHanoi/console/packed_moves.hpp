@@ -0,0 +1,139 @@
+// packed_moves.hpp — stockage compact de la solution
+// PackedMoves : 3 bits par mouvement (6 paires (from, to) possibles)
+// DirectionMoves : 1 bit par mouvement, la paire de piquets étant
+// déterminée par l'indice (i % 3) dans la solution optimale.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "hanoi_stream.hpp"
+
+// Codes 0..5 : AB, AC, BA, BC, CA, CB
+inline unsigned encode_move(Move m) {
+    unsigned from = m.first - 'A', to = m.second - 'A';
+    return from * 2 + (to > from ? to - 1 : to);
+}
+
+inline Move decode_move(unsigned code) {
+    static const Move table[6] = {{'A', 'B'}, {'A', 'C'}, {'B', 'A'},
+                                  {'B', 'C'}, {'C', 'A'}, {'C', 'B'}};
+    return table[code];
+}
+
+// Random-access iterator shared by the packed buffers (decodes on the fly)
+template <class Buffer>
+class PackedIterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Move;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = Move;
+
+    PackedIterator(const Buffer *b, size_t i) : buf(b), idx(i) {}
+
+    Move operator*() const { return (*buf)[idx]; }
+    Move operator[](difference_type k) const { return (*buf)[idx + k]; }
+    PackedIterator &operator++() { ++idx; return *this; }
+    PackedIterator operator++(int) { PackedIterator t = *this; ++idx; return t; }
+    PackedIterator &operator--() { --idx; return *this; }
+    PackedIterator &operator+=(difference_type k) { idx += k; return *this; }
+    PackedIterator operator+(difference_type k) const { return PackedIterator(buf, idx + k); }
+    difference_type operator-(const PackedIterator &o) const { return (difference_type)idx - (difference_type)o.idx; }
+    bool operator==(const PackedIterator &o) const { return idx == o.idx; }
+    bool operator!=(const PackedIterator &o) const { return idx != o.idx; }
+    bool operator<(const PackedIterator &o) const { return idx < o.idx; }
+
+private:
+    const Buffer *buf;
+    size_t idx;
+};
+
+// 21 moves of 3 bits per 64-bit word (no move straddles two words)
+class PackedMoves {
+public:
+    static const unsigned PER_WORD = 21;
+
+    void reserve(size_t n) { words.reserve((n + PER_WORD - 1) / PER_WORD); }
+    void clear() { words.clear(); count = 0; }
+    size_t size() const { return count; }
+    size_t memory_bytes() const { return words.capacity() * sizeof(uint64_t); }
+
+    void push_back(Move m) { push_code(encode_move(m)); }
+    void push_code(unsigned code) {
+        size_t slot = count % PER_WORD;
+        if (slot == 0) words.push_back(0);
+        words.back() |= (uint64_t)code << (3 * slot);
+        ++count;
+    }
+
+    // Zeroed buffer of n moves, then filled by index with set_code
+    // (threads filling disjoint ranges of PER_WORD moves never share a word)
+    void resize(size_t n) { words.assign((n + PER_WORD - 1) / PER_WORD, 0); count = n; }
+    void set_code(size_t i, unsigned code) {
+        words[i / PER_WORD] |= (uint64_t)code << (3 * (i % PER_WORD));
+    }
+
+    unsigned code_at(size_t i) const {
+        return (words[i / PER_WORD] >> (3 * (i % PER_WORD))) & 7;
+    }
+    Move operator[](size_t i) const { return decode_move(code_at(i)); }
+
+    PackedIterator<PackedMoves> begin() const { return PackedIterator<PackedMoves>(this, 0); }
+    PackedIterator<PackedMoves> end() const { return PackedIterator<PackedMoves>(this, count); }
+
+private:
+    std::vector<uint64_t> words;
+    size_t count = 0;
+};
+
+// pairs[i % 3] = pair of pegs used by move i (1-based) of the optimal
+// solution, in the order encoded by a 0 direction bit
+inline void direction_pairs(int n, char A, char C, char B, Move pairs[3]) {
+    if (n % 2 == 0) std::swap(C, B);
+    pairs[0] = {B, C};  // i % 3 == 0
+    pairs[1] = {A, C};  // i % 3 == 1
+    pairs[2] = {A, B};  // i % 3 == 2
+}
+
+// 1 bit per move: only valid for the optimal A -> C solution of n disks,
+// where move i (1-based) always involves the pair given by i % 3.
+// Bit 0 = from the first peg of the pair to the second, 1 = reverse.
+class DirectionMoves {
+public:
+    DirectionMoves(int n, char A, char C, char B) { direction_pairs(n, A, C, B, pairs); }
+
+    void reserve(size_t n) { bits.reserve((n + 63) / 64); }
+    void clear() { bits.clear(); count = 0; }
+    size_t size() const { return count; }
+    size_t memory_bytes() const { return bits.capacity() * sizeof(uint64_t); }
+
+    void push_back(Move m) {
+        if (count % 64 == 0) bits.push_back(0);
+        set(count++, m);
+    }
+
+    // Same contract as PackedMoves::resize, with ranges of 64 moves
+    void resize(size_t n) { bits.assign((n + 63) / 64, 0); count = n; }
+    void set(size_t i, Move m) {
+        if (m.first != pairs[(i + 1) % 3].first) bits[i / 64] |= 1ULL << (i % 64);
+    }
+    // 32 direction bits at once, i being a multiple of 32
+    void or_bits32(size_t i, uint32_t mask) { bits[i / 64] |= (uint64_t)mask << (i % 64); }
+
+    Move operator[](size_t i) const {
+        const Move &p = pairs[(i + 1) % 3];
+        bool reversed = (bits[i / 64] >> (i % 64)) & 1;
+        return reversed ? Move{p.second, p.first} : p;
+    }
+
+    PackedIterator<DirectionMoves> begin() const { return PackedIterator<DirectionMoves>(this, 0); }
+    PackedIterator<DirectionMoves> end() const { return PackedIterator<DirectionMoves>(this, count); }
+
+private:
+    Move pairs[3];
+    std::vector<uint64_t> bits;
+    size_t count = 0;
+};
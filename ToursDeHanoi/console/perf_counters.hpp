@@ -0,0 +1,139 @@
+// perf_counters.hpp — compteurs matériels (Linux perf_event_open) par phase
+// Chaque compteur est ouvert séparément avec inherit = 1 : les threads créés
+// pendant la phase (closed-form, work-stealing, SIMD) sont comptés dès qu'ils
+// se terminent. Seul l'espace utilisateur est mesuré (perf_event_paranoid 2).
+// Les allocations viennent des operator new remplacés dans main.cpp.
+// Sans perf_event_open (autre OS, conteneur, VM), seuls ces derniers restent.
+#pragma once
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Incremented by the global operator new replacements
+struct AllocCounters {
+    std::atomic<unsigned long long> count{0};
+    std::atomic<unsigned long long> bytes{0};
+};
+
+inline AllocCounters &alloc_counters() {
+    static AllocCounters c;
+    return c;
+}
+
+enum PerfEvent { PERF_CYCLES, PERF_INSTRUCTIONS, PERF_BRANCH_MISSES, PERF_L1D_MISSES, PERF_LLC_MISSES, PERF_PAGE_FAULTS, PERF_EVENTS };
+
+const char *const perf_event_names[PERF_EVENTS] = {"cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses", "page_faults"};
+
+// Counts of one phase; value[e] < 0 when event e could not be opened
+struct PerfSample {
+    long long value[PERF_EVENTS] = {-1, -1, -1, -1, -1, -1};
+    unsigned long long allocations = 0, alloc_bytes = 0;
+
+    bool available() const {
+        for (long long v : value) if (v >= 0) return true;
+        return false;
+    }
+    double ipc() const {
+        return value[PERF_CYCLES] > 0 && value[PERF_INSTRUCTIONS] >= 0
+                   ? (double)value[PERF_INSTRUCTIONS] / value[PERF_CYCLES] : -1;
+    }
+};
+
+class PerfCounters {
+public:
+    PerfCounters() {
+        for (int &fd : fds) fd = -1;
+#ifdef __linux__
+        const uint32_t types[PERF_EVENTS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                             PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_SOFTWARE};
+        const uint64_t configs[PERF_EVENTS] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+            PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+            PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+            PERF_COUNT_SW_PAGE_FAULTS};
+        for (int e = 0; e < PERF_EVENTS; e++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = types[e];
+            attr.config = configs[e];
+            attr.disabled = 1;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+            if (fds[e] < 0 && err.empty()) err = std::string(perf_event_names[e]) + ": " + std::strerror(errno);
+        }
+#else
+        err = "perf_event_open is Linux only";
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds) if (fd >= 0) close(fd);
+#endif
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    // First open failure (empty if every event is available)
+    const std::string &error() const { return err; }
+
+    void start() {
+        allocs = alloc_counters().count.load(std::memory_order_relaxed);
+        bytes = alloc_counters().bytes.load(std::memory_order_relaxed);
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    PerfSample stop() {
+        PerfSample s;
+#ifdef __linux__
+        for (int fd : fds) if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        for (int e = 0; e < PERF_EVENTS; e++) {
+            uint64_t buf[3];  // value, time enabled, time running
+            if (fds[e] < 0 || read(fds[e], buf, sizeof(buf)) != (ssize_t)sizeof(buf)) continue;
+            // multiplexed counters are scaled to the whole phase
+            if (buf[2] == 0) s.value[e] = buf[1] ? -1 : 0;
+            else s.value[e] = (long long)(buf[2] < buf[1] ? (double)buf[0] * buf[1] / buf[2] : buf[0]);
+        }
+#endif
+        s.allocations = alloc_counters().count.load(std::memory_order_relaxed) - allocs;
+        s.alloc_bytes = alloc_counters().bytes.load(std::memory_order_relaxed) - bytes;
+        return s;
+    }
+
+private:
+    int fds[PERF_EVENTS];
+    std::string err;
+    unsigned long long allocs = 0, bytes = 0;
+};
+
+// Counters of one phase for the RESULTS block (unavailable events skipped)
+inline void print_perf(std::ostream &os, const char *phase, const PerfSample &s) {
+    const char *labels[PERF_EVENTS] = {"Cycles", "Instructions", "Branch misses", "L1D read misses",
+                                       "LLC read misses", "Page faults"};
+    os << "Counters (" << phase << "):\n";
+    for (int e = 0; e < PERF_EVENTS; e++) {
+        if (s.value[e] >= 0) os << "  " << labels[e] << ": " << s.value[e] << "\n";
+        if (e == PERF_INSTRUCTIONS && s.ipc() >= 0) os << "  IPC: " << s.ipc() << "\n";
+    }
+    os << "  Allocations: " << s.allocations << " (" << s.alloc_bytes / (1024.0 * 1024.0) << " MB)\n";
+}
@@ -0,0 +1,469 @@
+// query_server.hpp — serveur de requêtes (socket Unix ou lot sur stdin)
+// Protocole texte, une requête par ligne, une réponse par ligne, dans
+// l'ordre ; le client peut envoyer plusieurs requêtes sans attendre
+// (pipeline) : chaque lot lu est réparti sur un pool fixe de workers.
+//   MOVE n k               -> OK A C       (mouvement k, 1 <= k <= 2^n - 1)
+//   STATE n k              -> OK ACCB...   (piquet du disque 1, 2, ... après k mouvements)
+//   COUNT FROM TO          -> OK 12        (plus court chemin entre configurations)
+//   PATH FROM TO [I [C]]   -> OK AC AB ... (C mouvements du chemin à partir de I)
+//   PING -> OK PONG ; STATS -> OK hits misses entries ; QUIT ferme la connexion
+// Erreurs : ERR message. Les plans FROM -> TO sont gardés dans un cache LRU,
+// avec les mouvements déjà matérialisés pour les chemins courts.
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "closed_form.hpp"
+#include "config_solver.hpp"
+#include "packed_moves.hpp"
+
+const unsigned long long PLAN_MATERIALIZE_LIMIT = 1ULL << 16;  // moves stored per cached plan
+const size_t MAX_PATH_REPLY = 4096;                           // moves per PATH answer
+const size_t MAX_QUERY_LINE = 4096;
+
+// Shortest path FROM -> TO as towers, with the index of each tower's first move
+struct PathPlan {
+    std::vector<TowerSegment> segments;
+    std::vector<unsigned long long> offsets;
+    unsigned long long total = 0;
+    std::vector<unsigned char> codes;  // encode_move of every move, short paths only
+
+    PathPlan(const Config &src, const Config &dst) {
+        ConfigMoveStream stream(src, dst);
+        segments = stream.segments();
+        total = stream.size();
+        unsigned long long at = 0;
+        for (const TowerSegment &s : segments) {
+            offsets.push_back(at);
+            at += (1ULL << s.disks) - 1;
+        }
+        if (total <= PLAN_MATERIALIZE_LIMIT) {
+            codes.reserve(total);
+            Move m;
+            while (stream.next(m)) codes.push_back((unsigned char)encode_move(m));
+        }
+    }
+
+    // Move i (0-based) of the path; towers are indexed with the closed form
+    Move at(unsigned long long i) const {
+        if (!codes.empty()) return decode_move(codes[i]);
+        size_t s = std::upper_bound(offsets.begin(), offsets.end(), i) - offsets.begin() - 1;
+        const TowerSegment &t = segments[s];
+        return move_at(t.disks, i - offsets[s] + 1, t.from, t.to, third_peg(t.from, t.to));
+    }
+};
+
+// Thread-safe LRU of plans; entries are shared so an eviction never
+// invalidates a plan a worker is still reading
+class PlanCache {
+public:
+    explicit PlanCache(size_t capacity) : capacity(capacity ? capacity : 1) {}
+
+    std::shared_ptr<const PathPlan> get(const Config &src, const Config &dst) {
+        std::string key(src.begin(), src.end());
+        key += ' ';
+        key.append(dst.begin(), dst.end());
+        {
+            std::lock_guard<std::mutex> lock(m);
+            auto it = index.find(key);
+            if (it != index.end()) {
+                order.splice(order.begin(), order, it->second);
+                hits++;
+                return it->second->second;
+            }
+        }
+        misses++;
+        auto plan = std::make_shared<const PathPlan>(src, dst);  // built outside the lock
+        std::lock_guard<std::mutex> lock(m);
+        if (index.find(key) == index.end()) {
+            order.emplace_front(key, plan);
+            index[key] = order.begin();
+            if (order.size() > capacity) {
+                index.erase(order.back().first);
+                order.pop_back();
+            }
+        }
+        return plan;
+    }
+
+    unsigned long long hit_count() const { return hits.load(); }
+    unsigned long long miss_count() const { return misses.load(); }
+    size_t size() {
+        std::lock_guard<std::mutex> lock(m);
+        return order.size();
+    }
+
+private:
+    typedef std::list<std::pair<std::string, std::shared_ptr<const PathPlan>>> Order;
+    size_t capacity;
+    std::mutex m;
+    Order order;  // most recent first
+    std::unordered_map<std::string, Order::iterator> index;
+    std::atomic<unsigned long long> hits{0}, misses{0};
+};
+
+// Answers one request line (without the newline)
+class QueryEngine {
+public:
+    explicit QueryEngine(size_t cache_entries) : cache(cache_entries) {}
+
+    std::string answer(const std::string &line) {
+        std::istringstream in(line);
+        std::string cmd, a, b, extra;
+        in >> cmd;
+        if (cmd == "PING") return "OK PONG";
+        if (cmd == "STATS") {
+            return "OK " + std::to_string(cache.hit_count()) + " " + std::to_string(cache.miss_count()) + " " +
+                   std::to_string(cache.size());
+        }
+        if (cmd == "MOVE" || cmd == "STATE") {
+            unsigned long long n, k;
+            if (!(in >> a >> b) || (in >> extra) || !parse_number(a, n) || !parse_number(b, k)) return "ERR usage: " + cmd + " n k";
+            if (n > 63) return "ERR n must be at most 63";
+            unsigned long long total = n == 0 ? 0 : (~0ULL >> (64 - n));
+            if (cmd == "MOVE") {
+                if (k < 1 || k > total) return "ERR k must be between 1 and 2^n - 1";
+                Move m = move_at((int)n, k);
+                return std::string("OK ") + m.first + " " + m.second;
+            }
+            if (k > total) return "ERR k must be at most 2^n - 1";
+            std::vector<char> pegs = state_after((int)n, k);
+            return "OK " + std::string(pegs.begin(), pegs.end());
+        }
+        if (cmd == "COUNT" || cmd == "PATH") {
+            Config src, dst;
+            if (!(in >> a >> b) || !parse_config(a, src) || !parse_config(b, dst) || src.size() != dst.size() ||
+                src.size() > 63)
+                return "ERR usage: " + cmd + " FROM TO (same length, at most 63 pegs among A, B, C)";
+            unsigned long long first = 0, count = MAX_PATH_REPLY;
+            if (cmd == "PATH") {
+                std::string f, c;
+                if (in >> f && !parse_number(f, first)) return "ERR bad start index";
+                if (in >> c && !parse_number(c, count)) return "ERR bad count";
+                if (in >> extra) return "ERR too many arguments";
+            } else if (in >> extra) {
+                return "ERR too many arguments";
+            }
+            std::shared_ptr<const PathPlan> plan = cache.get(src, dst);
+            if (cmd == "COUNT") return "OK " + std::to_string(plan->total);
+            if (count > MAX_PATH_REPLY) count = MAX_PATH_REPLY;
+            if (first > plan->total) first = plan->total;
+            unsigned long long last = std::min(plan->total, first + count);
+            std::string out = "OK";
+            out.reserve(2 + 3 * (last - first));
+            for (unsigned long long i = first; i < last; i++) {
+                Move m = plan->at(i);
+                out += ' ';
+                out += m.first;
+                out += m.second;
+            }
+            return out;
+        }
+        return cmd.empty() ? "ERR empty request" : "ERR unknown command " + cmd;
+    }
+
+private:
+    static bool parse_number(const std::string &s, unsigned long long &v) {
+        if (s.empty() || s.size() > 20 || s.find_first_not_of("0123456789") != std::string::npos) return false;
+        errno = 0;
+        v = std::strtoull(s.c_str(), nullptr, 10);
+        return errno == 0;
+    }
+
+    PlanCache cache;
+};
+
+// Fixed pool of workers; a batch of lines is cut into chunks and answered
+// in parallel, results kept in request order
+class QueryPool {
+public:
+    explicit QueryPool(unsigned threads) {
+        for (unsigned i = 0; i < (threads ? threads : 1); i++) {
+            workers.emplace_back([this] {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(m);
+                        cv.wait(lock, [this] { return stop || !tasks.empty(); });
+                        if (tasks.empty()) return;
+                        task = std::move(tasks.front());
+                        tasks.pop_front();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~QueryPool() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto &t : workers) t.join();
+    }
+
+    QueryPool(const QueryPool &) = delete;
+    QueryPool &operator=(const QueryPool &) = delete;
+
+    unsigned size() const { return (unsigned)workers.size(); }
+
+    // out[i] = engine.answer(lines[i]); returns when the whole batch is done
+    void run(QueryEngine &engine, const std::vector<std::string> &lines, std::vector<std::string> &out) {
+        out.assign(lines.size(), std::string());
+        if (lines.empty()) return;
+        size_t chunk = std::max<size_t>(16, lines.size() / (4 * workers.size()));
+        size_t chunks = (lines.size() + chunk - 1) / chunk;
+        std::mutex done_m;
+        std::condition_variable done_cv;
+        size_t left = chunks;
+        {
+            std::lock_guard<std::mutex> lock(m);
+            for (size_t c = 0; c < chunks; c++) {
+                tasks.emplace_back([&, c] {
+                    size_t end = std::min(lines.size(), (c + 1) * chunk);
+                    for (size_t i = c * chunk; i < end; i++) out[i] = engine.answer(lines[i]);
+                    std::lock_guard<std::mutex> lock(done_m);
+                    if (--left == 0) done_cv.notify_one();
+                });
+            }
+        }
+        cv.notify_all();
+        std::unique_lock<std::mutex> lock(done_m);
+        done_cv.wait(lock, [&] { return left == 0; });
+    }
+
+private:
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::thread> workers;
+    bool stop = false;
+};
+
+// Splits complete lines off `buffer`; false if a line exceeds MAX_QUERY_LINE
+inline bool take_lines(std::string &buffer, std::vector<std::string> &lines) {
+    size_t start = 0, nl;
+    while ((nl = buffer.find('\n', start)) != std::string::npos) {
+        size_t end = nl > start && buffer[nl - 1] == '\r' ? nl - 1 : nl;
+        lines.emplace_back(buffer, start, end - start);
+        start = nl + 1;
+    }
+    buffer.erase(0, start);
+    return buffer.size() <= MAX_QUERY_LINE;
+}
+
+inline bool send_all(int fd, const std::string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t w = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        sent += (size_t)w;
+    }
+    return true;
+}
+
+// One client: every read() may carry many requests, answered as one batch.
+// The caller closes fd.
+inline void serve_connection(int fd, QueryEngine &engine, QueryPool &pool) {
+    std::string buffer, reply;
+    std::vector<std::string> lines, answers;
+    char chunk[65536];
+    bool open = true;
+    while (open) {
+        ssize_t r = read(fd, chunk, sizeof chunk);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;
+        buffer.append(chunk, (size_t)r);
+        lines.clear();
+        bool fits = take_lines(buffer, lines);
+        auto quit = std::find(lines.begin(), lines.end(), "QUIT");
+        if (quit != lines.end()) {
+            lines.erase(quit, lines.end());
+            open = false;
+        }
+        pool.run(engine, lines, answers);
+        reply.clear();
+        for (const std::string &a : answers) reply += a + "\n";
+        if (!fits) {
+            reply += "ERR request line too long\n";
+            open = false;
+        }
+        if (!send_all(fd, reply)) break;
+    }
+}
+
+// Accepts clients on a Unix socket until `stop` is set (checked every 200 ms)
+inline bool serve_unix_socket(const std::string &path, QueryEngine &engine, QueryPool &pool,
+                              const std::atomic<bool> &stop, std::string &error) {
+    sockaddr_un addr;
+    if (path.size() >= sizeof(addr.sun_path)) { error = "socket path too long"; return false; }
+    int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (lfd < 0) { error = std::string("socket: ") + std::strerror(errno); return false; }
+    std::memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path.c_str());
+    ::unlink(path.c_str());  // stale socket of a previous run
+    if (bind(lfd, (sockaddr *)&addr, sizeof addr) != 0 || listen(lfd, 64) != 0) {
+        error = std::string("cannot listen on ") + path + ": " + std::strerror(errno);
+        close(lfd);
+        return false;
+    }
+    // one I/O thread per client (answers come from the pool), reaped when done
+    struct Client {
+        int fd;
+        std::atomic<bool> done{false};
+        std::thread io;
+    };
+    std::list<Client> clients;
+    auto reap = [&](bool all) {
+        for (auto it = clients.begin(); it != clients.end();) {
+            if (all) shutdown(it->fd, SHUT_RDWR);
+            if (!all && !it->done.load()) { ++it; continue; }
+            it->io.join();
+            close(it->fd);
+            it = clients.erase(it);
+        }
+    };
+    while (!stop.load()) {
+        reap(false);
+        pollfd p = {lfd, POLLIN, 0};
+        if (poll(&p, 1, 200) <= 0) continue;
+        int cfd = accept(lfd, nullptr, nullptr);
+        if (cfd < 0) continue;
+        clients.emplace_back();
+        Client &c = clients.back();
+        c.fd = cfd;
+        c.io = std::thread([&c, &engine, &pool] {
+            serve_connection(c.fd, engine, pool);
+            c.done = true;
+        });
+    }
+    close(lfd);
+    ::unlink(path.c_str());
+    reap(true);
+    return true;
+}
+
+inline int connect_unix(const std::string &path, std::string &error) {
+    sockaddr_un addr;
+    if (path.size() >= sizeof(addr.sun_path)) { error = "socket path too long"; return -1; }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    std::memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path.c_str());
+    if (fd < 0 || connect(fd, (sockaddr *)&addr, sizeof addr) != 0) {
+        error = "cannot connect to " + path + ": " + std::strerror(errno);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Load generator: `connections` clients, each sending `requests` queries in
+// pipelined groups of `pipeline`; latency = send of the group -> its answer
+struct LoadResult {
+    unsigned long long requests = 0, errors = 0;
+    double seconds = 0;
+    std::vector<double> latency_us;
+};
+
+inline std::string random_query(std::mt19937_64 &rng, int n, const std::vector<std::pair<std::string, std::string>> &pairs) {
+    unsigned long long total = (~0ULL >> (64 - n));
+    unsigned kind = rng() % 10;
+    if (kind < 4) return "MOVE " + std::to_string(n) + " " + std::to_string(rng() % total + 1);
+    if (kind < 7) return "STATE " + std::to_string(n) + " " + std::to_string(rng() % (total + 1));
+    const auto &p = pairs[rng() % pairs.size()];
+    if (kind < 9) return "COUNT " + p.first + " " + p.second;
+    return "PATH " + p.first + " " + p.second + " " + std::to_string(rng() % 1024) + " 16";
+}
+
+inline bool run_load(const std::string &path, unsigned connections, unsigned long long requests, unsigned pipeline,
+                     int n, LoadResult &result, std::string &error) {
+    if (pipeline == 0) pipeline = 1;
+    // a fixed set of configuration pairs, so that plans are reused (cache hits)
+    std::mt19937_64 seed_rng(42);
+    std::vector<std::pair<std::string, std::string>> pairs(64);
+    for (auto &p : pairs) {
+        for (int d = 0; d < n; d++) {
+            p.first += "ABC"[seed_rng() % 3];
+            p.second += "ABC"[seed_rng() % 3];
+        }
+    }
+    std::vector<int> fds;
+    for (unsigned c = 0; c < connections; c++) {
+        int fd = connect_unix(path, error);
+        if (fd < 0) {
+            for (int f : fds) close(f);
+            return false;
+        }
+        fds.push_back(fd);
+    }
+    std::vector<LoadResult> parts(connections);
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned c = 0; c < connections; c++) {
+        threads.emplace_back([&, c] {
+            LoadResult &r = parts[c];
+            std::mt19937_64 rng(1000 + c);
+            std::string buffer, batch;
+            std::vector<std::string> lines;
+            char chunk[65536];
+            while (r.requests < requests) {
+                unsigned k = (unsigned)std::min<unsigned long long>(pipeline, requests - r.requests);
+                batch.clear();
+                for (unsigned i = 0; i < k; i++) batch += random_query(rng, n, pairs) + "\n";
+                auto s0 = std::chrono::steady_clock::now();
+                if (!send_all(fds[c], batch)) return;
+                size_t got = 0;
+                while (got < k) {
+                    ssize_t rd = read(fds[c], chunk, sizeof chunk);
+                    if (rd <= 0) return;
+                    buffer.append(chunk, (size_t)rd);
+                    lines.clear();
+                    take_lines(buffer, lines);
+                    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - s0).count();
+                    for (const std::string &l : lines) {
+                        if (l.compare(0, 2, "OK") != 0) r.errors++;
+                        r.latency_us.push_back(us);
+                    }
+                    got += lines.size();
+                }
+                r.requests += k;
+            }
+        });
+    }
+    for (auto &t : threads) t.join();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    for (int fd : fds) close(fd);
+    for (const LoadResult &r : parts) {
+        result.requests += r.requests;
+        result.errors += r.errors;
+        result.latency_us.insert(result.latency_us.end(), r.latency_us.begin(), r.latency_us.end());
+    }
+    if (result.requests < requests * connections) {
+        error = "server closed the connection";
+        return false;
+    }
+    return true;
+}
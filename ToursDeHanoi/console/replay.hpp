@@ -0,0 +1,73 @@
+// replay.hpp — rejeu et validation d'une suite de mouvements
+// Chaque piquet est un masque 64 bits (bit d-1 = disque d) : le disque du
+// dessus est le bit de poids faible, un mouvement est légal si la cible
+// n'a aucun disque plus petit. Fonctionne sur tout générateur / buffer.
+#pragma once
+#include <cstdint>
+#include "hanoi_stream.hpp"
+
+struct ReplayResult {
+    long long applied = 0;      // moves applied successfully
+    long long error_index = -1; // 0-based index of the first illegal move
+    bool solved = false;        // all n disks on C at the end
+};
+
+class BitboardReplay {
+public:
+    // n <= 64 disks, all on A
+    explicit BitboardReplay(int n) : full(n >= 64 ? ~0ULL : (1ULL << n) - 1), count(0), ok(true) {
+        pegs[0] = full;
+        pegs[1] = pegs[2] = 0;
+    }
+
+    // Arbitrary starting position (masks of pegs A, B, C)
+    BitboardReplay(uint64_t a, uint64_t b, uint64_t c) : full(a | b | c), count(0), ok(true) {
+        pegs[0] = a;
+        pegs[1] = b;
+        pegs[2] = c;
+    }
+
+    bool apply(Move m) {
+        unsigned f = (unsigned)(m.first - 'A'), t = (unsigned)(m.second - 'A');
+        if (f > 2 || t > 2 || f == t) return fail();
+        uint64_t src = pegs[f];
+        uint64_t top = src & (0 - src);
+        // empty source, or a smaller disk already on the target
+        if (!top || (pegs[t] & (top - 1))) return fail();
+        pegs[f] = src ^ top;
+        pegs[t] |= top;
+        ++count;
+        return true;
+    }
+
+    ReplayResult result() const {
+        ReplayResult r;
+        r.applied = count;
+        r.error_index = ok ? -1 : count;
+        r.solved = ok && pegs[0] == 0 && pegs[1] == 0 && pegs[2] == full;
+        return r;
+    }
+
+    uint64_t peg(int i) const { return pegs[i]; }
+
+private:
+    bool fail() {
+        ok = false;
+        return false;
+    }
+
+    uint64_t pegs[3];
+    uint64_t full;
+    long long count;
+    bool ok;
+};
+
+// Replays any range of moves (vector, packed buffer, stream)
+template <class Range>
+ReplayResult replay_moves(int n, Range &&moves) {
+    BitboardReplay board(n);
+    for (Move m : moves) {
+        if (!board.apply(m)) break;
+    }
+    return board.result();
+}
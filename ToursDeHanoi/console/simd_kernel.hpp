@@ -0,0 +1,168 @@
+// simd_kernel.hpp — génération vectorisée de blocs de mouvements
+// Pour un bloc de L mouvements d'indices k = base + l (base multiple de L,
+// l = 1..L), la formule de closed_form.hpp se réduit à :
+//   source = (base % 3 + F[l]) % 3,  cible = (base % 3 + T[l]) % 3
+// avec F et T des tables constantes ; seul le dernier mouvement (l = L,
+// qui propage une retenue dans base) est calculé en scalaire.
+// L = 32 en AVX2, 64 en AVX-512 ; sélection à l'exécution selon le CPU.
+#pragma once
+#include <cstdint>
+#include <immintrin.h>
+#include "closed_form.hpp"
+#include "packed_moves.hpp"
+
+static_assert(sizeof(Move) == 2, "Move must be two packed chars");
+
+// Per-lane tables for lane j (l = j + 1): source/target offsets and l % 3
+template <int L>
+struct SimdTables {
+    alignas(64) uint8_t F[L], T[L], G[L];
+    SimdTables() {
+        for (int j = 0; j < L; j++) {
+            unsigned l = j + 1;
+            F[j] = (l & (l - 1)) % 3;
+            T[j] = ((l | (l - 1)) + 1) % 3;
+            G[j] = l % 3;
+        }
+    }
+};
+
+// Peg names indexed by peg number (B and C swapped for even n)
+inline void peg_names(int n, char name[3]) {
+    name[0] = 'A'; name[1] = 'B'; name[2] = 'C';
+    if (n % 2 == 0) std::swap(name[1], name[2]);
+}
+
+// Scalar fallback: moves first..first+count-1 (0-based indices)
+inline void hanoi_simd_scalar(int n, unsigned long long first, unsigned long long count, Move *out) {
+    for (unsigned long long i = first; i < first + count; i++) out[i] = move_at(n, i + 1);
+}
+
+// Bits: DirectionMoves or any buffer with the same set / or_bits32 contract
+template <class Bits>
+inline void hanoi_simd_scalar(int n, unsigned long long first, unsigned long long count, Bits &out) {
+    for (unsigned long long i = first; i < first + count; i++) out.set(i, move_at(n, i + 1));
+}
+
+// x in 0..4 -> x % 3 (x - 3 wraps above x when x < 3)
+__attribute__((target("avx2")))
+inline __m256i mod3_epu8_avx2(__m256i x) {
+    return _mm256_min_epu8(x, _mm256_sub_epi8(x, _mm256_set1_epi8(3)));
+}
+
+// `first` must be a multiple of 32
+__attribute__((target("avx2")))
+inline void hanoi_simd_avx2(int n, unsigned long long first, unsigned long long count, Move *out) {
+    static const SimdTables<32> tab;
+    char name[3];
+    peg_names(n, name);
+    const __m256i vF = _mm256_load_si256((const __m256i *)tab.F);
+    const __m256i vT = _mm256_load_si256((const __m256i *)tab.T);
+    const __m256i vName = _mm256_setr_epi8(name[0], name[1], name[2], 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                           name[0], name[1], name[2], 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    unsigned long long end = first + count, i = first;
+    unsigned r = (unsigned)(i % 3);
+    for (; i + 32 <= end; i += 32, r = (r + 2) % 3) {
+        const __m256i vr = _mm256_set1_epi8((char)r);
+        __m256i f = mod3_epu8_avx2(_mm256_add_epi8(vF, vr));
+        __m256i t = mod3_epu8_avx2(_mm256_add_epi8(vT, vr));
+        f = _mm256_shuffle_epi8(vName, f);
+        t = _mm256_shuffle_epi8(vName, t);
+        // interleave (from, to) bytes, then undo the per-128-bit-lane unpack order
+        __m256i lo = _mm256_unpacklo_epi8(f, t), hi = _mm256_unpackhi_epi8(f, t);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(out + i + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+        out[i + 31] = move_at(n, i + 32);
+    }
+    hanoi_simd_scalar(n, i, end - i, out);
+}
+
+template <class Bits>
+__attribute__((target("avx2")))
+inline void hanoi_simd_avx2(int n, unsigned long long first, unsigned long long count, Bits &out) {
+    static const SimdTables<32> tab;
+    const __m256i vF = _mm256_load_si256((const __m256i *)tab.F);
+    const __m256i vG = _mm256_load_si256((const __m256i *)tab.G);
+    const __m256i one = _mm256_set1_epi8(1);
+    unsigned long long end = first + count, i = first;
+    unsigned r = (unsigned)(i % 3);
+    for (; i + 32 <= end; i += 32, r = (r + 2) % 3) {
+        const __m256i vr = _mm256_set1_epi8((char)r);
+        __m256i f = mod3_epu8_avx2(_mm256_add_epi8(vF, vr));
+        __m256i g = mod3_epu8_avx2(_mm256_add_epi8(vG, vr));
+        // first peg of the pair: 1 when k % 3 == 0 (B <-> C), else 0
+        __m256i pairFirst = _mm256_and_si256(_mm256_cmpeq_epi8(g, _mm256_setzero_si256()), one);
+        uint32_t same = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(f, pairFirst));
+        out.or_bits32(i, ~same & 0x7FFFFFFFu);
+        out.set(i + 31, move_at(n, i + 32));
+    }
+    hanoi_simd_scalar(n, i, end - i, out);
+}
+
+// `first` must be a multiple of 64
+__attribute__((target("avx512f,avx512bw")))
+inline void hanoi_simd_avx512(int n, unsigned long long first, unsigned long long count, Move *out) {
+    static const SimdTables<64> tab;
+    char name[3];
+    peg_names(n, name);
+    const __m512i vF = _mm512_load_si512(tab.F);
+    const __m512i vT = _mm512_load_si512(tab.T);
+    // peg names in bytes 0..2 of every 128-bit lane (vpshufb works per lane)
+    const int packed = (unsigned char)name[0] | (unsigned char)name[1] << 8 | (unsigned char)name[2] << 16;
+    const __m512i vName = _mm512_set4_epi32(0, 0, 0, packed);
+    const __m512i three = _mm512_set1_epi8(3);
+    const __m512i idx0 = _mm512_setr_epi64(0, 1, 8, 9, 2, 3, 10, 11);
+    const __m512i idx1 = _mm512_setr_epi64(4, 5, 12, 13, 6, 7, 14, 15);
+    unsigned long long end = first + count, i = first;
+    unsigned r = (unsigned)(i % 3);
+    for (; i + 64 <= end; i += 64, r = (r + 1) % 3) {
+        const __m512i vr = _mm512_set1_epi8((char)r);
+        __m512i f = _mm512_add_epi8(vF, vr), t = _mm512_add_epi8(vT, vr);
+        f = _mm512_min_epu8(f, _mm512_sub_epi8(f, three));
+        t = _mm512_min_epu8(t, _mm512_sub_epi8(t, three));
+        f = _mm512_shuffle_epi8(vName, f);
+        t = _mm512_shuffle_epi8(vName, t);
+        __m512i lo = _mm512_unpacklo_epi8(f, t), hi = _mm512_unpackhi_epi8(f, t);
+        _mm512_storeu_si512(out + i, _mm512_permutex2var_epi64(lo, idx0, hi));
+        _mm512_storeu_si512(out + i + 32, _mm512_permutex2var_epi64(lo, idx1, hi));
+        out[i + 63] = move_at(n, i + 64);
+    }
+    hanoi_simd_scalar(n, i, end - i, out);
+}
+
+enum class SimdLevel { Scalar, AVX2, AVX512 };
+
+inline SimdLevel detect_simd_level() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    return SimdLevel::Scalar;
+}
+
+inline const char *simd_level_name(SimdLevel level) {
+    return level == SimdLevel::AVX512 ? "AVX-512" : (level == SimdLevel::AVX2 ? "AVX2" : "scalar");
+}
+
+// Whole solution into out[0 .. 2^n - 2], slices of 64-move blocks per thread
+inline void hanoi_simd(int n, Move *out, unsigned threads, SimdLevel level) {
+    unsigned long long total = (1ULL << n) - 1;
+    parallel_move_slices(total, threads, 64, [=](unsigned long long first, unsigned long long last) {
+        unsigned long long i = first - 1, count = last - first + 1;
+        if (level == SimdLevel::AVX512) hanoi_simd_avx512(n, i, count, out);
+        else if (level == SimdLevel::AVX2) hanoi_simd_avx2(n, i, count, out);
+        else hanoi_simd_scalar(n, i, count, out);
+    });
+}
+
+// 1-bit direction output (AVX2 kernel at most: 32 bits per movemask).
+// `out` must already hold 2^n - 1 zeroed moves (DirectionMoves::resize,
+// or a mapped MoveFileWriter).
+template <class Bits>
+inline void hanoi_simd(int n, Bits &out, unsigned threads, SimdLevel level) {
+    unsigned long long total = (1ULL << n) - 1;
+    parallel_move_slices(total, threads, 64, [=, &out](unsigned long long first, unsigned long long last) {
+        unsigned long long i = first - 1, count = last - first + 1;
+        if (level != SimdLevel::Scalar) hanoi_simd_avx2(n, i, count, out);
+        else hanoi_simd_scalar(n, i, count, out);
+    });
+}
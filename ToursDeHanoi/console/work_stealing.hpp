@@ -0,0 +1,183 @@
+// work_stealing.hpp — pool de threads à vol de tâches + récursif parallèle
+// Chaque worker a sa propre file : il empile/dépile ses tâches par l'arrière
+// et, quand elle est vide, vole la tâche la plus ancienne d'un autre worker.
+// Un worker sans travail réessaie quelques fois puis s'endort sur une
+// variable de condition : un pool inactif ne consomme pas de CPU.
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "hanoi_stream.hpp"
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // The calling thread acts as worker 0, so `threads - 1` threads are started
+    explicit WorkStealingPool(unsigned threads) : queues(threads ? threads : 1), stop(false) {
+        for (unsigned w = 1; w < queues.size(); w++) {
+            workers.emplace_back([this, w] {
+                self() = w;
+                unsigned misses = 0;
+                while (!stop.load(std::memory_order_acquire)) {
+                    if (run_one()) misses = 0;
+                    else if (++misses < SPIN_TRIES) std::this_thread::yield();
+                    else {
+                        park([this] { return stop.load() || queued.load() > 0; });
+                        misses = 0;
+                    }
+                }
+            });
+        }
+    }
+
+    ~WorkStealingPool() {
+        stop.store(true);
+        wake_all();
+        for (auto &t : workers) t.join();
+    }
+
+    unsigned size() const { return (unsigned)queues.size(); }
+
+    void spawn(Task task) {
+        Queue &q = queues[self()];
+        {
+            std::lock_guard<std::mutex> lock(q.m);
+            q.tasks.push_back(std::move(task));
+        }
+        queued.fetch_add(1);
+        if (sleepers.load() > 0) {
+            std::lock_guard<std::mutex> lock(idle_m);
+            idle_cv.notify_one();
+        }
+    }
+
+    // Runs one task: own queue first (LIFO), then steal from the others (FIFO)
+    bool run_one() {
+        Task task;
+        unsigned me = self();
+        if (!pop_back(queues[me], task)) {
+            for (unsigned i = 1; i < queues.size() && !task; i++) {
+                steal_front(queues[(me + i) % queues.size()], task);
+            }
+        }
+        if (!task) return false;
+        queued.fetch_sub(1);
+        task();
+        return true;
+    }
+
+    // Called by a forked task when it is done (wakes a parked wait())
+    void complete(std::atomic<int> &pending) {
+        if (pending.fetch_sub(1) == 1) wake_all();
+    }
+
+    // Helps with other tasks until `pending` drops to zero, then parks
+    void wait(const std::atomic<int> &pending) {
+        unsigned misses = 0;
+        while (pending.load(std::memory_order_acquire) > 0) {
+            if (run_one()) misses = 0;
+            else if (++misses < SPIN_TRIES) std::this_thread::yield();
+            else {
+                park([this, &pending] { return pending.load() <= 0 || queued.load() > 0; });
+                misses = 0;
+            }
+        }
+    }
+
+private:
+    static const unsigned SPIN_TRIES = 64;  // failed attempts before parking
+
+
+    struct Queue {
+        std::mutex m;
+        std::deque<Task> tasks;
+    };
+
+    // Sleeps until ready(); sleepers is raised before the check, and spawn()
+    // raises queued before reading sleepers, so no wake-up is lost
+    template <class Ready>
+    void park(Ready ready) {
+        std::unique_lock<std::mutex> lock(idle_m);
+        sleepers.fetch_add(1);
+        idle_cv.wait(lock, ready);
+        sleepers.fetch_sub(1);
+    }
+
+    void wake_all() {
+        if (sleepers.load() == 0) return;
+        std::lock_guard<std::mutex> lock(idle_m);
+        idle_cv.notify_all();
+    }
+
+    static unsigned &self() {
+        static thread_local unsigned index = 0;
+        return index;
+    }
+
+    static bool pop_back(Queue &q, Task &task) {
+        std::lock_guard<std::mutex> lock(q.m);
+        if (q.tasks.empty()) return false;
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    static bool steal_front(Queue &q, Task &task) {
+        std::unique_lock<std::mutex> lock(q.m, std::try_to_lock);
+        if (!lock.owns_lock() || q.tasks.empty()) return false;
+        task = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        return true;
+    }
+
+    std::vector<Queue> queues;
+    std::vector<std::thread> workers;
+    std::atomic<bool> stop;
+    std::atomic<size_t> queued{0};     // tasks waiting in the queues
+    std::atomic<unsigned> sleepers{0};
+    std::mutex idle_m;
+    std::condition_variable idle_cv;
+};
+
+// Serial recursive algorithm writing at a given position instead of push_back
+inline void hanoi_recursive_into(int n, char A, char C, char B, Move *&out) {
+    if (n != 0) {
+        hanoi_recursive_into(n - 1, A, B, C, out);
+        *out++ = {A, C};  // Move(A, C)
+        hanoi_recursive_into(n - 1, B, C, A, out);
+    }
+}
+
+// The left subtree of size 2^(n-1) - 1 starts at out, the middle move is at
+// out[2^(n-1) - 1] and the right subtree follows: both halves are
+// independent, so the left one is forked while depth < cutoff_depth.
+inline void hanoi_recursive_parallel(WorkStealingPool &pool, int n, char A, char C, char B,
+                                     Move *out, int cutoff_depth) {
+    if (n == 0) return;
+    if (cutoff_depth <= 0 || n < 12) {
+        hanoi_recursive_into(n, A, C, B, out);
+        return;
+    }
+    unsigned long long half = (1ULL << (n - 1)) - 1;
+    std::atomic<int> pending(1);
+    pool.spawn([&pool, &pending, n, A, B, C, out, cutoff_depth] {
+        hanoi_recursive_parallel(pool, n - 1, A, B, C, out, cutoff_depth - 1);
+        pool.complete(pending);
+    });
+    out[half] = {A, C};
+    hanoi_recursive_parallel(pool, n - 1, B, C, A, out + half + 1, cutoff_depth - 1);
+    pool.wait(pending);
+}
+
+// Default cutoff: about 8 subtrees per worker to balance the load
+inline int default_cutoff_depth(unsigned threads) {
+    int depth = 3;
+    while ((1u << depth) < threads * 8 && depth < 20) depth++;
+    return depth;
+}
@@ -0,0 +1,87 @@
+// frame_profiler.hpp — temps de chaque image : mise à jour, dessin, affichage
+// Trois durées par image (en ms) plus le nombre de mouvements joués ;
+// le HUD lit les moyennes des dernières images, l'export CSV garde tout.
+// Dans une fenêtre, « display » inclut l'attente de la limite de 60 fps.
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct FrameTimes {
+    double update = 0, draw = 0, display = 0;  // ms
+    long long moves = 0;                       // moves applied during the frame
+    double total() const { return update + draw + display; }
+};
+
+class FrameProfiler {
+public:
+    // frames beyond maxFrames are counted but not kept
+    explicit FrameProfiler(size_t maxFrames = 1 << 20) : limit(maxFrames) { frames_.reserve(std::min<size_t>(limit, 4096)); }
+
+    void begin() { t0 = Clock::now(); }    // start of the frame (events, update)
+    void updated() { t1 = Clock::now(); }  // before the first draw call
+    void drawn() { t2 = Clock::now(); }    // before display()
+    void displayed(long long moves) {
+        auto t3 = Clock::now();
+        FrameTimes f;
+        f.update = ms(t1 - t0);
+        f.draw = ms(t2 - t1);
+        f.display = ms(t3 - t2);
+        f.moves = moves;
+        if (frames_.size() < limit) frames_.push_back(f);
+        else dropped++;
+    }
+
+    const std::vector<FrameTimes> &frames() const { return frames_; }
+    size_t droppedFrames() const { return dropped; }
+
+    // mean of the last `window` frames
+    FrameTimes recent(size_t window = 60) const {
+        FrameTimes m;
+        size_t k = std::min(window, frames_.size());
+        for (size_t i = frames_.size() - k; i < frames_.size(); i++) {
+            m.update += frames_[i].update;
+            m.draw += frames_[i].draw;
+            m.display += frames_[i].display;
+            m.moves += frames_[i].moves;
+        }
+        if (k) { m.update /= k; m.draw /= k; m.display /= k; m.moves /= (long long)k; }
+        return m;
+    }
+
+    // p in [0, 1] over all kept frames, for one phase (&FrameTimes::draw, ...)
+    double percentile(double FrameTimes::*phase, double p) const {
+        if (frames_.empty()) return 0;
+        std::vector<double> v(frames_.size());
+        for (size_t i = 0; i < v.size(); i++) v[i] = frames_[i].*phase;
+        size_t k = (size_t)(p * (v.size() - 1) + 0.5);
+        std::nth_element(v.begin(), v.begin() + k, v.end());
+        return v[k];
+    }
+    double mean(double FrameTimes::*phase) const {
+        double s = 0;
+        for (const FrameTimes &f : frames_) s += f.*phase;
+        return frames_.empty() ? 0 : s / frames_.size();
+    }
+
+    bool writeCsv(const std::string &path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+        out << "frame,update_ms,draw_ms,display_ms,total_ms,moves\n";
+        for (size_t i = 0; i < frames_.size(); i++) {
+            const FrameTimes &f = frames_[i];
+            out << i << ',' << f.update << ',' << f.draw << ',' << f.display << ',' << f.total() << ',' << f.moves << '\n';
+        }
+        return (bool)out;
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+    static double ms(Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); }
+
+    std::vector<FrameTimes> frames_;
+    size_t limit, dropped = 0;
+    Clock::time_point t0, t1, t2;
+};
@@ -0,0 +1,159 @@
+// history_log.hpp — journal binaire des exécutions, en ajout seul
+// Format : en-tête de 16 octets (« HANOIHS\n », version, taille d'un
+// enregistrement) puis des enregistrements de 32 octets. Au démarrage le
+// fichier est projeté (mmap) en lecture ; chaque nouvelle exécution est
+// ajoutée par un seul write() en O_APPEND et gardée aussi en mémoire.
+// Un enregistrement incomplet en fin de fichier (arrêt brutal) est ignoré.
+// Les statistiques par (n, méthode) sont agrégées en une passe.
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct HistoryRecord {
+    int64_t when;           // unix time of the end of the run
+    double timeFinal;       // animation time (s)
+    double timeGeneration;  // generator busy time (s), < 0: not measured
+    int32_t n;
+    uint32_t flags;         // HISTORY_RECURSIVE
+};
+static_assert(sizeof(HistoryRecord) == 32, "record layout");
+
+const uint32_t HISTORY_RECURSIVE = 1;
+const uint32_t HISTORY_VERSION = 1;
+
+struct HistoryLogHeader {
+    char magic[8];  // "HANOIHS\n"
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+// Aggregate of the animation times of one (n, method)
+struct RunStats {
+    int n = 0;
+    bool recursive = false;
+    size_t count = 0;
+    double mean = 0, median = 0, best = 0, meanGeneration = -1;
+};
+
+class HistoryLog {
+public:
+    HistoryLog() = default;
+    ~HistoryLog() { reset(); }
+    HistoryLog(const HistoryLog &) = delete;
+    HistoryLog &operator=(const HistoryLog &) = delete;
+
+    // Creates the file if needed and maps the existing records; on failure
+    // nothing is kept open (runs then stay in memory only)
+    bool open(const std::string &path, std::string &error) {
+        reset();
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) return fail(error, "cannot open " + path + ": " + std::strerror(errno));
+        struct stat st;
+        if (fstat(fd, &st) != 0) return fail(error, std::strerror(errno));
+        HistoryLogHeader h;
+        if (st.st_size == 0) {
+            std::memcpy(h.magic, "HANOIHS\n", 8);
+            h.version = HISTORY_VERSION;
+            h.recordSize = sizeof(HistoryRecord);
+            if (write(fd, &h, sizeof(h)) != (ssize_t)sizeof(h)) return fail(error, "cannot write header");
+            return true;
+        }
+        if ((size_t)st.st_size < sizeof(h)) return fail(error, "file too small");
+        void *p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return fail(error, std::string("mmap failed: ") + std::strerror(errno));
+        base = (char *)p;
+        mapped = (size_t)st.st_size;
+        std::memcpy(&h, base, sizeof(h));
+        if (std::memcmp(h.magic, "HANOIHS\n", 8) != 0 || h.version != HISTORY_VERSION || h.recordSize != sizeof(HistoryRecord))
+            return fail(error, "not a history log (or another version)");
+        records = (const HistoryRecord *)(base + sizeof(h));
+        stored = (mapped - sizeof(h)) / sizeof(HistoryRecord);
+        if (stored * sizeof(HistoryRecord) + sizeof(h) != mapped) {
+            // drop the torn tail so the next append stays aligned
+            if (ftruncate(fd, (off_t)(sizeof(h) + stored * sizeof(HistoryRecord))) != 0) return fail(error, "cannot repair log");
+        }
+        return true;
+    }
+
+    size_t size() const { return stored + added.size(); }
+    const HistoryRecord &operator[](size_t i) const { return i < stored ? records[i] : added[i - stored]; }
+
+    // Without an open file the record is only kept for this session
+    void append(int n, bool recursive, double timeFinal, double timeGeneration) {
+        HistoryRecord r;
+        r.when = (int64_t)std::time(nullptr);
+        r.timeFinal = timeFinal;
+        r.timeGeneration = timeGeneration;
+        r.n = n;
+        r.flags = recursive ? HISTORY_RECURSIVE : 0;
+        added.push_back(r);
+        if (fd >= 0 && write(fd, &r, sizeof(r)) != (ssize_t)sizeof(r)) {
+            close(fd);  // keep going in memory
+            fd = -1;
+        }
+    }
+
+    // One pass over all records, sorted by n then method
+    std::vector<RunStats> aggregate() const {
+        std::map<std::pair<int, bool>, std::vector<double>> times;
+        std::map<std::pair<int, bool>, std::pair<double, size_t>> generation;
+        for (size_t i = 0; i < size(); i++) {
+            const HistoryRecord &r = (*this)[i];
+            std::pair<int, bool> key(r.n, (r.flags & HISTORY_RECURSIVE) != 0);
+            times[key].push_back(r.timeFinal);
+            if (r.timeGeneration >= 0) {
+                generation[key].first += r.timeGeneration;
+                generation[key].second++;
+            }
+        }
+        std::vector<RunStats> out;
+        for (auto &kv : times) {
+            std::vector<double> &v = kv.second;
+            RunStats s;
+            s.n = kv.first.first;
+            s.recursive = kv.first.second;
+            s.count = v.size();
+            for (double t : v) s.mean += t;
+            s.mean /= v.size();
+            s.best = *std::min_element(v.begin(), v.end());
+            std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+            s.median = v[v.size() / 2];
+            auto g = generation.find(kv.first);
+            if (g != generation.end()) s.meanGeneration = g->second.first / g->second.second;
+            out.push_back(s);
+        }
+        return out;
+    }
+
+private:
+    bool fail(std::string &error, const std::string &message) {
+        error = message;
+        reset();
+        return false;
+    }
+    void reset() {
+        if (base) munmap(base, mapped);
+        if (fd >= 0) close(fd);
+        base = nullptr;
+        records = nullptr;
+        mapped = stored = 0;
+        fd = -1;
+    }
+
+    int fd = -1;
+    char *base = nullptr;
+    size_t mapped = 0, stored = 0;
+    const HistoryRecord *records = nullptr;
+    std::vector<HistoryRecord> added;  // this session's runs
+};
@@ -4,14 +4,28 @@
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <cstdlib>
+#include <iostream>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "../console/closed_form.hpp"
+#include "../console/move_file.hpp"
+#include "spsc_ring.hpp"
+#include "../console/gui_generators.hpp"
+#include "frame_profiler.hpp"
+#include "history_log.hpp"
 
 using namespace std;
 
 struct MenuResult { int diskCount; bool recursive; };
-struct HistoryEntry { int n; bool recursive; double timeFinal; };
 
-static vector<pair<char,char>> moves;
-static vector<HistoryEntry> history;
+static HistoryLog historyLog; // every finished (or abandoned) run, kept across sessions
+const char *HISTORY_FILE = "hanoi_history.bin";
+
+const int MAX_ANIM_DISKS = 30;         // menu and move-file limit
+const size_t MOVE_RING_SIZE = 1 << 20; // moves buffered between generator and animation
+const long long BENCH_FRAMES = 4096;   // default length of the offscreen benchmark
 
 // Helper: format double
 string formatDouble(double v, int prec=6){
@@ -27,82 +41,144 @@ bool containsCircle(const sf::CircleShape &c, sf::Vector2i m){
     return c.getGlobalBounds().contains((float)m.x,(float)m.y);
 }
 
-// Draw capsule (rectangle + left/right circles)
-void drawCapsule(sf::RenderTarget &target, const sf::RectangleShape &rect, const sf::Color &fill){
-    // body rect
-    sf::RectangleShape body = rect;
-    body.setFillColor(fill);
-    target.draw(body);
-
-    // left & right circles
-    float h = rect.getSize().y;
-    float r = h/2.f;
-    sf::CircleShape left(r), right(r);
-    left.setFillColor(fill); right.setFillColor(fill);
-    left.setOrigin(r,r); right.setOrigin(r,r);
-    left.setPosition(rect.getPosition().x, rect.getPosition().y + r);
-    right.setPosition(rect.getPosition().x + rect.getSize().x, rect.getPosition().y + r);
-    target.draw(left); target.draw(right);
-}
+// Capsule built once (body, round ends, centered text); only its fill changes
+struct Capsule {
+    sf::RectangleShape body;
+    sf::CircleShape left, right;
+    sf::Text text;
+
+    Capsule(const sf::RectangleShape &rect, const sf::Color &fill, const sf::Font &font, const string &label,
+            unsigned int size, const sf::Color &textColor = sf::Color::White)
+        : body(rect), left(rect.getSize().y/2.f), right(rect.getSize().y/2.f), text(label, font, size){
+        float r = rect.getSize().y/2.f;
+        body.setFillColor(fill);
+        left.setFillColor(fill); right.setFillColor(fill);
+        left.setOrigin(r,r); right.setOrigin(r,r);
+        left.setPosition(rect.getPosition().x, rect.getPosition().y + r);
+        right.setPosition(rect.getPosition().x + rect.getSize().x, rect.getPosition().y + r);
+        text.setFillColor(textColor);
+        sf::FloatRect b = text.getLocalBounds();
+        text.setOrigin(b.left + b.width/2.f, b.top + b.height/2.f);
+        text.setPosition(rect.getPosition() + rect.getSize()*0.5f);
+    }
+    void setFill(const sf::Color &fill){
+        body.setFillColor(fill); left.setFillColor(fill); right.setFillColor(fill);
+    }
+    void draw(sf::RenderTarget &target) const {
+        target.draw(body); target.draw(left); target.draw(right); target.draw(text);
+    }
+};
 
-// Draw capsule with centered text
-void drawCapsuleText(sf::RenderTarget &target, const sf::RectangleShape &rect, const sf::Color &fill,
-                     const sf::Font &font, const string &text, unsigned int size, const sf::Color &textColor = sf::Color::White){
-    drawCapsule(target, rect, fill);
-    sf::Text t(text, font, size);
-    t.setFillColor(textColor);
-    sf::FloatRect b = t.getLocalBounds();
-    t.setOrigin(b.left + b.width/2.f, b.top + b.height/2.f);
-    t.setPosition(rect.getPosition() + rect.getSize()*0.5f);
-    target.draw(t);
+// Screens are redrawn only after events that can change them (not mouse moves)
+bool changesScreen(const sf::Event &ev){
+    return ev.type != sf::Event::MouseMoved && ev.type != sf::Event::MouseEntered && ev.type != sf::Event::MouseLeft;
 }
 
-// Hanoi recursive moves generator
-void hanoiRec(int n, char A, char C, char B){
-    if(n != 0){
-        hanoiRec(n-1, A, B, C);
-        moves.push_back({A, C}); // Move(A, C)
-        hanoiRec(n-1, B, C, A);
+// Generator thread feeding the animation through a bounded lock-free ring;
+// it waits while the ring is full, and stops when the owner is destroyed
+struct MoveProducer {
+    struct Cancelled {};
+    SpscRing<Move> ring;
+    atomic<bool> done{false}, stop{false};
+    double genSeconds = 0, waitSeconds = 0; // published by done
+    thread worker;
+
+    MoveProducer(int n, bool recursive) : ring(MOVE_RING_SIZE) {
+        worker = thread([this, n, recursive]{
+            auto t0 = chrono::steady_clock::now();
+            try {
+                if (recursive) hanoiRec(n,'A','C','B',*this); else hanoiIter(n,'A','C','B',*this);
+            } catch (const Cancelled &) {}
+            chrono::duration<double> total = chrono::steady_clock::now() - t0;
+            genSeconds = total.count() - waitSeconds;
+            done.store(true, memory_order_release);
+        });
     }
-}
-// Hanoi iterative (simulation) moves generator
-void hanoiIter(int n, char A, char C, char B){
-    struct Peg { vector<int> s; };
-    Peg pegA, pegB, pegC;
-    for(int i=n;i>=1;--i) pegA.s.push_back(i);
-
-    auto mv = [&](Peg& P1, Peg& P2, char c1, char c2){
-        if(P1.s.empty()){
-            moves.push_back({c2,c1});
-            P1.s.push_back(P2.s.back()); P2.s.pop_back();
-        } else if(P2.s.empty()){
-            moves.push_back({c1,c2});
-            P2.s.push_back(P1.s.back()); P1.s.pop_back();
-        } else if(P1.s.back() < P2.s.back()){
-            moves.push_back({c1,c2});
-            P2.s.push_back(P1.s.back()); P1.s.pop_back();
-        } else {
-            moves.push_back({c2,c1});
-            P1.s.push_back(P2.s.back()); P2.s.pop_back();
+    ~MoveProducer(){ stop = true; worker.join(); }
+
+    // sink of the generators (producer thread only)
+    void operator()(char from, char to){
+        if (ring.try_push({from, to})) return;
+        auto w0 = chrono::steady_clock::now();
+        for (int spin = 0; !ring.try_push({from, to}); ++spin){
+            if (stop.load(memory_order_relaxed)) throw Cancelled();
+            if (spin < 64) this_thread::yield(); else this_thread::sleep_for(chrono::microseconds(200));
         }
-    };
-
-    char p1 = A, p2 = B, p3 = C;
-    if(n % 2 == 0) swap(p2,p3);
-
-    long long total = (1LL<<n) - 1;
-    for(long long i=1;i<=total;++i){
-        if(i%3==1) mv(pegA, pegC, p1, p3);
-        else if(i%3==2) mv(pegA, pegB, p1, p2);
-        else mv(pegB, pegC, p2, p3);
+        chrono::duration<double> waited = chrono::steady_clock::now() - w0;
+        waitSeconds += waited.count();
     }
+    bool finished() const { return done.load(memory_order_acquire); }
+};
+
+// Moves one disk of the mesh (4 vertices of a quad) onto a peg, top edge at y
+void placeDisk(sf::Vertex *quad, float w, float h, char peg, float y){
+    float x = (peg=='A'?200.f:(peg=='B'?450.f:700.f)) - w/2.f + 5.f;
+    quad[0].position = sf::Vector2f(x, y);
+    quad[1].position = sf::Vector2f(x + w, y);
+    quad[2].position = sf::Vector2f(x + w, y + h);
+    quad[3].position = sf::Vector2f(x, y + h);
 }
 
-void placeDisk(sf::RectangleShape &d, char peg, int heightIndex){
-    float x = (peg=='A'?200.f:(peg=='B'?450.f:700.f));
-    float w = d.getSize().x;
-    d.setPosition(x - w/2.f + 5.f, 450.f - heightIndex*22.f);
-}
+// Rods + all disks in one vertex array (one quad each), updated in place;
+// shared by the window and the offscreen benchmark
+struct DiskScene {
+    int n;
+    float diskStep, diskH;
+    sf::RectangleShape rods[3];
+    sf::VertexArray diskMesh;
+    vector<float> diskW;
+    vector<int> pegA, pegB, pegC;
+
+    // up to 8 disks: the original sizes (160 - 20 i wide, 22 px apart)
+    explicit DiskScene(int n) : n(n), diskMesh(sf::Quads, 4 * n), diskW(n) {
+        diskStep = n > 10 ? 220.f / n : 22.f;
+        diskH = diskStep > 3.f ? diskStep - 2.f : diskStep;
+        for (int r = 0; r < 3; r++){
+            rods[r].setSize(sf::Vector2f(10,250));
+            rods[r].setFillColor(sf::Color(90,60,20));
+            rods[r].setPosition(200 + 250*r, 200);
+        }
+        for (int i = 0; i < n; i++) {
+            diskW[i] = n > 8 ? 160.f - i * 140.f / (n - 1) : 160.f - i * 20;
+
+            // Palette style "aurore" (spread over the same range when n > 8)
+            float t = n > 8 ? i * 7.f / (n - 1) : (float)i;
+            sf::Color c((sf::Uint8)(255 - t * 15),   // du rose/orangé lumineux
+                        (sf::Uint8)(180 + t * 10),   // léger vert/orangé
+                        (sf::Uint8)(200 - t * 20));  // bleu/violet clair
+            for (int v = 0; v < 4; v++) diskMesh[4*i + v].color = c;
+        }
+        placeAll(vector<char>(n, 'A'));
+    }
+
+    vector<int> &peg(char p){ return p=='A' ? pegA : (p=='B' ? pegB : pegC); }
+    void moveDisk(int id, char p, int heightIndex){
+        placeDisk(&diskMesh[4*id], diskW[id], diskH, p, 450.f - heightIndex*diskStep);
+    }
+    // put every disk on the peg given by st, as returned by state_after()
+    // (st[d-1] = peg of disk d, 1 = smallest; mesh index 0 = largest disk)
+    void placeAll(const vector<char> &st){
+        pegA.clear(); pegB.clear(); pegC.clear();
+        for (int i = 0; i < n; ++i){
+            char p = st[n-1-i];
+            moveDisk(i, p, peg(p).size());
+            peg(p).push_back(i);
+        }
+    }
+    // one move on the peg stacks; only the moved disk's quad changes
+    void applyMove(Move mv){
+        vector<int> &src = peg(mv.first), &dst = peg(mv.second);
+        if (!src.empty()){
+            int id = src.back(); src.pop_back();
+            moveDisk(id, mv.second, dst.size());
+            dst.push_back(id);
+        }
+    }
+    void draw(sf::RenderTarget &target) const {
+        for (const sf::RectangleShape &r : rods) target.draw(r);
+        target.draw(diskMesh);
+    }
+};
 
 /* ---------------- History Window ---------------- */
 void runHistoryWindow(const sf::Font &font){
@@ -110,80 +186,137 @@ void runHistoryWindow(const sf::Font &font){
     sf::RenderWindow w(sf::VideoMode(W,H), "History");
     w.setFramerateLimit(60);
 
-    sf::Text title("Execution History", font, 26);
+    sf::Text title("", font, 26);
     title.setFillColor(sf::Color(30,30,40));
     title.setPosition(20,10);
+    sf::RectangleShape band(sf::Vector2f((float)W, 56.f)); // keeps scrolled cards under the title
+    band.setFillColor(sf::Color(245,245,250));
+    sf::RectangleShape footBand(sf::Vector2f((float)W, 36.f));
+    footBand.setPosition(0, H-36.f);
+    footBand.setFillColor(sf::Color(245,245,250));
+    sf::Text foot("Mouse wheel / PageUp / PageDown / Home / End: scroll    Tab: runs / statistics", font, 14);
+    foot.setFillColor(sf::Color(140,140,140));
+    foot.setPosition(14, H-28);
 
     float scroll=0.f;
     const float cardH = 78.f;
     const float spacing = 14.f;
+    const float rowH = cardH + spacing, listTop = 60.f, listBottom = H - 36.f;
+
+    // runs newest first, or one row per (n, method) aggregated once on opening
+    bool statsView = false;
+    vector<RunStats> stats = historyLog.aggregate();
+    auto rows = [&](){ return statsView ? stats.size() : historyLog.size(); };
+    auto maxScroll = [&](){
+        float m = rows() * rowH - (listBottom - listTop);
+        return m > 0 ? m : 0.f;
+    };
 
-    while(w.isOpen()){
-        sf::Event ev;
-        while(w.pollEvent(ev)){
-            if(ev.type == sf::Event::Closed){ w.close(); return; }
-            if(ev.type == sf::Event::MouseWheelScrolled){
-                scroll -= ev.mouseWheelScroll.delta * 30.f;
-                if(scroll < 0) scroll = 0;
+    // only the cards on screen exist; rebuilt when the view moves
+    struct Card { sf::RectangleShape box, badge; sf::Text line1, line2; };
+    vector<Card> visible;
+    bool dirty = true;
+    auto rebuild = [&](){
+        visible.clear();
+        title.setString(statsView ? "Statistics per (n, method)"
+                                  : "Execution History (" + to_string(historyLog.size()) + " runs)");
+        for(size_t i = (size_t)(scroll / rowH); i < rows(); ++i){
+            float y = listTop + i*rowH - scroll;
+            if (y > listBottom) break;
+            Card c;
+            c.box.setSize(sf::Vector2f(W-80.f, cardH));
+            c.box.setPosition(40.f, y);
+            c.box.setFillColor(sf::Color::White);
+            c.box.setOutlineThickness(1.5f);
+            c.box.setOutlineColor(sf::Color(210,210,210));
+
+            int n; bool recursive; string l1, l2;
+            if (statsView){
+                const RunStats &st = stats[i];
+                n = st.n; recursive = st.recursive;
+                l1 = "   (" + to_string(st.count) + (st.count > 1 ? " runs)" : " run)");
+                l2 = "Mean " + formatDouble(st.mean,4) + " s   Median " + formatDouble(st.median,4) +
+                     " s   Best " + formatDouble(st.best,4) + " s";
+                if (st.meanGeneration >= 0) l2 += "   Gen " + formatDouble(st.meanGeneration,4) + " s";
+            } else {
+                const HistoryRecord &r = historyLog[historyLog.size() - 1 - i];
+                n = r.n; recursive = r.flags & HISTORY_RECURSIVE;
+                char date[32] = "";
+                time_t when = (time_t)r.when;
+                strftime(date, sizeof date, "%Y-%m-%d %H:%M", localtime(&when));
+                l1 = string("   ") + date;
+                l2 = "Time: " + formatDouble(r.timeFinal,6) + " s";
+                if (r.timeGeneration >= 0) l2 += "   Generation: " + formatDouble(r.timeGeneration,6) + " s";
             }
-        }
-
-        w.clear(sf::Color(245,245,250));
-
-        w.draw(title);
-
-        float y = 60.f - scroll;
-        for(size_t i=0;i<history.size();++i){
-            const HistoryEntry &he = history[i];
-            sf::RectangleShape card(sf::Vector2f(W-80.f, cardH));
-            card.setPosition(40.f, y);
-            card.setFillColor(sf::Color::White);
-            card.setOutlineThickness(1.5f);
-            card.setOutlineColor(sf::Color(210,210,210));
-
-            sf::Text line1("n = " + to_string(he.n) + "   Method: " + (he.recursive ? "Recursive" : "Iterative"),
-                           font, 18);
-            line1.setFillColor(sf::Color(20,20,30));
-            line1.setPosition(60.f, y + 10.f);
-
-            sf::Text line2("Time: " + formatDouble(he.timeFinal,6) + " s", font, 16);
-            line2.setFillColor(sf::Color(90,90,110));
-            line2.setPosition(60.f, y + 38.f);
+            c.line1 = sf::Text("n = " + to_string(n) + "   Method: " + (recursive ? "Recursive" : "Iterative") + l1,
+                               font, 18);
+            c.line1.setFillColor(sf::Color(20,20,30));
+            c.line1.setPosition(60.f, y + 10.f);
+            c.line2 = sf::Text(l2, font, 16);
+            c.line2.setFillColor(sf::Color(90,90,110));
+            c.line2.setPosition(60.f, y + 38.f);
 
             // small color badge
-            sf::RectangleShape badge(sf::Vector2f(12,12));
-            badge.setPosition(40.f + card.getSize().x - 40.f, y + 12.f);
-            badge.setFillColor(he.recursive ? sf::Color(190,150,240) : sf::Color(180,180,180));
+            c.badge.setSize(sf::Vector2f(12,12));
+            c.badge.setPosition(40.f + c.box.getSize().x - 40.f, y + 12.f);
+            c.badge.setFillColor(recursive ? sf::Color(190,150,240) : sf::Color(180,180,180));
+            visible.push_back(c);
+        }
+        dirty = false;
+    };
+    auto scrollTo = [&](float v){
+        scroll = v < 0 ? 0 : (v > maxScroll() ? maxScroll() : v);
+        dirty = true;
+    };
 
-            w.draw(card);
-            w.draw(line1);
-            w.draw(line2);
-            w.draw(badge);
+    // redrawn only after an event that changes it; waitEvent sleeps in between
+    bool redraw = true;
+    while(w.isOpen()){
+        if (dirty) rebuild();
+        if (redraw){
+            w.clear(sf::Color(245,245,250));
+
+            for (const Card &c : visible){
+                w.draw(c.box);
+                w.draw(c.line1);
+                w.draw(c.line2);
+                w.draw(c.badge);
+            }
 
-            y += cardH + spacing;
-        }
+            w.draw(band);
+            w.draw(title);
+            w.draw(footBand);
+            w.draw(foot);
 
-        sf::Text foot("Use mouse wheel to scroll", font, 14);
-        foot.setFillColor(sf::Color(140,140,140));
-        foot.setPosition(14, H-28);
-        w.draw(foot);
+            w.display();
+            redraw = false;
+        }
 
-        w.display();
+        sf::Event ev;
+        if (!w.waitEvent(ev)) return;
+        do {
+            if(ev.type == sf::Event::Closed){ w.close(); return; }
+            if(changesScreen(ev)) redraw = true;
+            if(ev.type == sf::Event::MouseWheelScrolled) scrollTo(scroll - ev.mouseWheelScroll.delta * 30.f);
+            if(ev.type == sf::Event::KeyPressed){
+                float page = listBottom - listTop;
+                if (ev.key.code == sf::Keyboard::PageDown) scrollTo(scroll + page);
+                if (ev.key.code == sf::Keyboard::PageUp) scrollTo(scroll - page);
+                if (ev.key.code == sf::Keyboard::Home) scrollTo(0);
+                if (ev.key.code == sf::Keyboard::End) scrollTo(maxScroll());
+                if (ev.key.code == sf::Keyboard::Tab){ statsView = !statsView; scrollTo(0); }
+            }
+        } while(w.pollEvent(ev));
     }
 }
 
 /* ---------------- Menu ---------------- */
-MenuResult runMenu(){
+// Built once; the loop sleeps in waitEvent and redraws only after a change
+MenuResult runMenu(const sf::Font &font){
     const int W = 900, H = 600;
     sf::RenderWindow win(sf::VideoMode(W,H), "Hanoi - Menu");
     win.setFramerateLimit(60);
 
-    sf::Font font;
-    if(!font.loadFromFile("Roboto-Regular.ttf")){
-        // if missing, return defaults (no console prints)
-        return {3,true};
-    }
-
     int diskCount = 3;
     bool recursive = true;
 
@@ -196,6 +329,11 @@ MenuResult runMenu(){
     diskText.setFillColor(sf::Color(40,40,40));
     diskText.setPosition(300, 140);
 
+    // small hint
+    sf::Text hint("Max " + to_string(MAX_ANIM_DISKS) + " disks for graphic animation", font, 14);
+    hint.setFillColor(sf::Color(120,120,120));
+    hint.setPosition(300, 200);
+
     // plus/minus - use circles violet pastel (option 3)
     sf::CircleShape minusCircle(30.f);
     minusCircle.setPosition(260,220);
@@ -221,168 +359,275 @@ MenuResult runMenu(){
         plusT.setPosition(plusCircle.getPosition() + sf::Vector2f(plusCircle.getRadius(), plusCircle.getRadius()-4));
     }
 
+    // Colors per your choices
+    sf::Color startColor(255, 200, 220);      // rose clair
+    sf::Color historyColor(200, 235, 255);    // bleu ciel clair
+    sf::Color recSelColor(180, 140, 220);     // violet moyen
+    sf::Color iterUnselColor(170, 170, 170);  // grey for unselected
+
     // method selection capsules (rounded) — recursive selected violet medium (option 2)
     sf::RectangleShape recChoice(sf::Vector2f(240,72)); recChoice.setPosition(140,330);
-    sf::RectangleShape iterChoice(sf::RectangleShape(sf::Vector2f(240,72))); iterChoice.setPosition(520,330);
-
-    sf::Text recTxt("Recursive", font, 28);
-    recTxt.setFillColor(sf::Color::White);
-    {
-        sf::FloatRect b = recTxt.getLocalBounds();
-        recTxt.setOrigin(b.left + b.width/2.f, b.top + b.height/2.f);
-        recTxt.setPosition(recChoice.getPosition() + recChoice.getSize()*0.5f);
-    }
-
-    sf::Text iterTxt("Iterative", font, 28);
-    iterTxt.setFillColor(sf::Color::White);
-    {
-        sf::FloatRect b = iterTxt.getLocalBounds();
-        iterTxt.setOrigin(b.left + b.width/2.f, b.top + b.height/2.f);
-        iterTxt.setPosition(iterChoice.getPosition() + iterChoice.getSize()*0.5f);
-    }
+    sf::RectangleShape iterChoice(sf::Vector2f(240,72)); iterChoice.setPosition(520,330);
+    Capsule recButton(recChoice, recSelColor, font, "Recursive", 28);
+    Capsule iterButton(iterChoice, iterUnselColor, font, "Iterative", 28);
 
     // START and HISTORY (oval capsules)
     sf::RectangleShape startRect(sf::Vector2f(220,70));
     startRect.setPosition(160, 460);
-    sf::RectangleShape historyRect(sf::RectangleShape(sf::Vector2f(220,70)));
+    sf::RectangleShape historyRect(sf::Vector2f(220,70));
     historyRect.setPosition(520, 460);
+    Capsule startButton(startRect, startColor, font, "START", 24);
+    Capsule historyButton(historyRect, historyColor, font, "HISTORY", 20);
 
-    // Colors per your choices
-    sf::Color startColor(255, 200, 220);      // rose clair
-    sf::Color historyColor(200, 235, 255);    // bleu ciel clair
-    sf::Color backColor(60, 140, 255);        // bleu vif
-    sf::Color recSelColor(180, 140, 220);     // violet moyen
-    sf::Color iterUnselColor(170, 170, 170);  // grey for unselected
-
+    bool dirty = true;
     while (win.isOpen()){
+        if (dirty){
+            // draw UI
+            win.clear(sf::Color(245,245,250));
+
+            win.draw(title);
+            win.draw(diskText);
+            win.draw(hint);
+
+            // plus/minus circles and their text
+            win.draw(minusCircle);
+            win.draw(minusT);
+            win.draw(plusCircle);
+            win.draw(plusT);
+
+            recButton.draw(win);
+            iterButton.draw(win);
+            startButton.draw(win);
+            historyButton.draw(win);
+
+            win.display();
+            dirty = false;
+        }
+
         sf::Event ev;
-        while (win.pollEvent(ev)){
+        if (!win.waitEvent(ev)) break;
+        do {
             if (ev.type == sf::Event::Closed){ win.close(); exit(0); }
+            if (changesScreen(ev)) dirty = true; // resize, focus, keys, clicks
             if (ev.type == sf::Event::MouseButtonPressed){
-                sf::Vector2i m = sf::Mouse::getPosition(win);
+                sf::Vector2i m(ev.mouseButton.x, ev.mouseButton.y);
 
                 // minus circle
                 if (containsCircle(minusCircle, m) && diskCount > 1){
                     diskCount--;
                     diskText.setString("Number of disks: " + to_string(diskCount));
                 }
-                // plus circle, limit to 8
-                if (containsCircle(plusCircle, m) && diskCount < 8){
+                // plus circle, limit to MAX_ANIM_DISKS
+                if (containsCircle(plusCircle, m) && diskCount < MAX_ANIM_DISKS){
                     diskCount++;
                     diskText.setString("Number of disks: " + to_string(diskCount));
                 }
 
                 // method selecting by clicking the capsule bounding rect
-                if (recChoice.getGlobalBounds().contains((float)m.x,(float)m.y)) recursive = true;
-                if (iterChoice.getGlobalBounds().contains((float)m.x,(float)m.y)) recursive = false;
+                if (containsRect(recChoice, m)) recursive = true;
+                if (containsRect(iterChoice, m)) recursive = false;
+                recButton.setFill(recursive ? recSelColor : iterUnselColor);
+                iterButton.setFill(!recursive ? recSelColor : iterUnselColor);
 
                 // Start
-                if (startRect.getGlobalBounds().contains((float)m.x,(float)m.y)){
+                if (containsRect(startRect, m)){
                     win.close();
                     return {diskCount, recursive};
                 }
                 // History
-                if (historyRect.getGlobalBounds().contains((float)m.x,(float)m.y)){
+                if (containsRect(historyRect, m)){
                     runHistoryWindow(font);
                 }
             }
-        }
-
-        // set capsule fills
-        recChoice.setFillColor(recursive ? recSelColor : iterUnselColor);
-        iterChoice.setFillColor(!recursive ? recSelColor : iterUnselColor);
-
-        // draw UI
-        win.clear(sf::Color(245,245,250));
-
-        win.draw(title);
-        win.draw(diskText);
-
-        // plus/minus circles and their text
-        win.draw(minusCircle);
-        win.draw(minusT);
-        win.draw(plusCircle);
-        win.draw(plusT);
-
-        // draw capsules
-        drawCapsule(win, recChoice, recChoice.getFillColor());
-        drawCapsule(win, iterChoice, iterChoice.getFillColor());
-        // centered texts are pre-positioned
-        win.draw(recTxt);
-        win.draw(iterTxt);
-
-        // draw start/history capsules with text
-        drawCapsuleText(win, startRect, startColor, font, "START", 24);
-        drawCapsuleText(win, historyRect, historyColor, font, "HISTORY", 20);
-
-        // small hint
-        sf::Text hint("Max 8 disks for graphic animation", font, 14);
-        hint.setFillColor(sf::Color(120,120,120));
-        hint.setPosition(300, 200);
-        win.draw(hint);
-
-        win.display();
+        } while (win.pollEvent(ev));
     }
 
     return {3, true};
 }
 
 /* ---------------- Animation ---------------- */
-void runAnimation(int n, bool recursiveMethod, const sf::Font &font){
+// file != nullptr: play the moves of a move file (mapped, not copied)
+void runAnimation(int n, bool recursiveMethod, const sf::Font &font, const MoveFile *file = nullptr){
     sf::RenderWindow win(sf::VideoMode(900,600), "Hanoi Animation");
     win.setFramerateLimit(60);
 
     sf::Text timerText("", font, 22);
     timerText.setFillColor(sf::Color(20,20,30));
     timerText.setPosition(10, 10);
+    sf::Text genText("", font, 16);
+    genText.setFillColor(sf::Color(60,60,70));
+    genText.setPosition(10, 68);
 
-    // BACK button (blue vif)
+    // BACK button (blue vif), built once
     sf::RectangleShape backRect(sf::Vector2f(220,56));
     backRect.setPosition(640, 18);
-    backRect.setFillColor(sf::Color(60,140,255));
-
-    // rods
-    sf::RectangleShape rod(sf::Vector2f(10,250)); rod.setFillColor(sf::Color(90,60,20));
-    sf::RectangleShape Arod=rod, Brod=rod, Crod=rod;
-    Arod.setPosition(200,200); Brod.setPosition(450,200); Crod.setPosition(700,200);
-
-    // create disks with pastel palette (soft)
-    vector<sf::RectangleShape> disks;
-    vector<int> pegA, pegB, pegC ;
-    
-    for (int i = 0; i < n; i++) {
-    float w = 160 - i * 20;
-    sf::RectangleShape d(sf::Vector2f(w, 20));
-
-    // Palette style "aurore"
-    sf::Uint8 r = 255 - i * 15;  // du rose/orangé lumineux
-    sf::Uint8 g = 180 + i * 10;  // léger vert/orangé
-    sf::Uint8 b = 200 - i * 20;  // bleu/violet clair
-    if(r > 255) r = 255;
-    if(g > 255) g = 255;
-    if(b > 255) b = 255;
-    d.setFillColor(sf::Color(r, g, b));
-
-    d.setPosition(200 - w / 2 + 5, 450 - i * 22);
-    disks.push_back(d);
-    pegA.push_back(i);
-}
-    moves.clear();
-    if (recursiveMethod) hanoiRec(n,'A','C','B'); else hanoiIter(n,'A','C','B');
+    Capsule backButton(backRect, sf::Color(60,140,255), font, "BACK TO MENU", 18);
+
+    DiskScene scene(n);
+
+    // moves: mapped file, or streamed from the generator thread (rendering
+    // starts at once); after a seek, the closed form gives any move
+    unique_ptr<MoveProducer> producer;
+    if (!file) producer.reset(new MoveProducer(n, recursiveMethod));
+    double genTime = -1; // generator busy time, once it has finished
+    const long long total = file ? (long long)file->size() : (1LL << n) - 1;
+    auto moveAt = [&](long long i) -> Move {
+        if (file) return (*file)[i];
+        return move_at(n, i + 1);
+    };
+    const bool closedForm = !file || file->optimal(); // state_after() gives any position
 
-    int step = 0;
+    long long step = 0;
     bool finished = false;
-    bool saved = false;
-    const float speed = 0.35f; // animation delay per move
+    bool saved = file != nullptr; // file replays are not timed runs
+    bool seeked = false; // after a jump the timer no longer measures a full run
+
+    // playback rate (Up / Down keys): starts at one move every 0.35 s;
+    // above a few moves per frame, positions are jumped to with state_after()
+    double rate = 1.0 / 0.35, pending = 0;
+    const double maxRate = 134217728.0; // 2^27 moves/s
+    sf::Text rateText("", font, 16);
+    rateText.setFillColor(sf::Color(60,60,70));
+    rateText.setPosition(10, 44);
+    auto showRate = [&](){
+        rateText.setString("Speed: " + formatDouble(rate, rate < 10 ? 2 : 0) + " moves/s (Up/Down)");
+    };
+    showRate();
+
+    // seek bar (drag or click) and "go to move" field (digits + Enter)
+    const float barX = 100.f, barW = 700.f, barY = 550.f;
+    sf::RectangleShape seekTrack(sf::Vector2f(barW, 8));
+    seekTrack.setPosition(barX, barY);
+    seekTrack.setFillColor(sf::Color(220,220,230));
+    sf::RectangleShape seekFill(sf::Vector2f(0, 8));
+    seekFill.setPosition(barX, barY);
+    seekFill.setFillColor(sf::Color(180,140,220));
+    sf::CircleShape seekHandle(9.f);
+    seekHandle.setOrigin(9.f, 9.f);
+    seekHandle.setFillColor(sf::Color(150,110,200));
+    sf::Text stepText("", font, 16);
+    stepText.setFillColor(sf::Color(60,60,70));
+    stepText.setPosition(barX, barY - 30.f);
+    sf::Text jumpText("Go to move: _", font, 16);
+    jumpText.setFillColor(sf::Color(60,60,70));
+    jumpText.setPosition(barX + 420.f, barY - 30.f);
+    string jumpInput;
+    bool dragging = false;
+    long long shownStep = -1;
 
     sf::Clock timerClock;
     sf::Clock moveClock;
 
+    // file start configuration (start()[d-1] = peg of disk d)
+    vector<char> startState(n, 'A');
+    if (file){
+        string start = file->start();
+        startState.assign(start.begin(), start.end());
+    }
+    scene.placeAll(startState);
+
+    // configuration after k moves
+    auto jumpTo = [&](long long k){
+        if (closedForm) scene.placeAll(state_after(n, (unsigned long long)k));
+        else {
+            // arbitrary start: replay the first k moves
+            vector<char> st = startState;
+            for (long long j = 0; j < k; ++j){
+                Move m = moveAt(j);
+                for (int d = 0; d < n; ++d) if (st[d] == m.first){ st[d] = m.second; break; } // smallest disk on the peg
+            }
+            scene.placeAll(st);
+        }
+        step = k;
+    };
+    auto seekTo = [&](long long k){
+        if (k < 0) k = 0;
+        if (k > total) k = total;
+        if (producer && !producer->finished()) genText.setString("Generation: stopped (seek)");
+        producer.reset(); // the stream no longer matches the position
+        jumpTo(k);
+        seeked = true;
+        pending = 0;
+    };
+    auto seekFromMouse = [&](int mx){
+        float f = (mx - barX) / barW;
+        if (f < 0) f = 0;
+        if (f > 1) f = 1;
+        seekTo((long long)(f * total + 0.5f));
+    };
+    // frame profiler: H shows the HUD, S writes every frame to a CSV file
+    FrameProfiler profiler;
+    bool showHud = false;
+    sf::Text hudText("", font, 14);
+    hudText.setFillColor(sf::Color(30,90,60));
+    hudText.setPosition(560, 90);
+    string hudStatus;
+    long long frameMoves = 0, frameCount = 0;
+
+    // events (the back button is a click event, not a per-frame mouse poll)
+    bool backClicked = false, redraw = true;
+    auto handleEvent = [&](const sf::Event &ev){
+        if (ev.type == sf::Event::Closed){ win.close(); exit(0); }
+        if (changesScreen(ev) || dragging) redraw = true;
+        if (ev.type == sf::Event::MouseButtonPressed && ev.mouseButton.button == sf::Mouse::Left){
+            sf::Vector2i m(ev.mouseButton.x, ev.mouseButton.y);
+            sf::FloatRect hit(barX, barY - 10.f, barW, 28.f);
+            if (containsRect(backRect, m)) backClicked = true;
+            else if (hit.contains((float)m.x, (float)m.y)){
+                dragging = true;
+                seekFromMouse(m.x);
+            }
+        }
+        if (ev.type == sf::Event::MouseMoved && dragging) seekFromMouse(ev.mouseMove.x);
+        if (ev.type == sf::Event::MouseButtonReleased) dragging = false;
+        if (ev.type == sf::Event::KeyPressed){
+            if (ev.key.code == sf::Keyboard::Up && rate < maxRate){ rate *= 2; showRate(); }
+            if (ev.key.code == sf::Keyboard::Down && rate > 0.5){ rate /= 2; showRate(); }
+            if (ev.key.code == sf::Keyboard::H) showHud = !showHud;
+            if (ev.key.code == sf::Keyboard::S){
+                string path = "frames_" + to_string(n) + ".csv";
+                hudStatus = profiler.writeCsv(path) ? "saved " + path : "cannot write " + path;
+                showHud = true;
+            }
+        }
+        if (ev.type == sf::Event::TextEntered){
+            sf::Uint32 c = ev.text.unicode;
+            if (c >= '0' && c <= '9' && jumpInput.size() < 10) jumpInput += (char)c;
+            else if (c == 8 && !jumpInput.empty()) jumpInput.pop_back(); // backspace
+            else if ((c == 13 || c == 10) && !jumpInput.empty()){   // enter
+                seekTo(atoll(jumpInput.c_str()));
+                jumpInput.clear();
+            }
+            jumpText.setString("Go to move: " + jumpInput + "_");
+        }
+    };
+
     while (win.isOpen()){
+        // timed frames only while something moves; once the run is over (and
+        // the generator has reported), sleep in waitEvent until the next event
+        bool idle = finished && (!producer || genTime >= 0);
         sf::Event ev;
-        while (win.pollEvent(ev)){
-            if (ev.type == sf::Event::Closed){ win.close(); exit(0); }
+        if (idle){
+            redraw = false;
+            if (!win.waitEvent(ev)) return;
+            handleEvent(ev);
+            moveClock.restart(); // the wait is not playback time
         }
+        profiler.begin();
+        long long stepBefore = step;
+        while (win.pollEvent(ev)) handleEvent(ev);
+
+        // Back button: if clicked before finishing, save current approximate time
+        if (backClicked){
+            if (!finished && !saved && !seeked){
+                double t = timerClock.getElapsedTime().asSeconds();
+                historyLog.append(n, recursiveMethod, t, genTime);
+                saved = true;
+            }
+            win.close();
+            return;
+        }
+        if (idle && !redraw) continue; // mouse moves: nothing to redraw
 
         // update timer only while running
         if (!finished){
@@ -390,70 +635,208 @@ void runAnimation(int n, bool recursiveMethod, const sf::Font &font){
             timerText.setString("Time: " + formatDouble(t,6) + " s");
         }
 
-        // Back button: if clicked before finishing, save current approximate time
-        if (sf::Mouse::isButtonPressed(sf::Mouse::Left)){
-            sf::Vector2i mp = sf::Mouse::getPosition(win);
-            if (backRect.getGlobalBounds().contains((float)mp.x,(float)mp.y)){
-                if (!finished && !saved){
-                    double t = timerClock.getElapsedTime().asSeconds();
-                    history.push_back({n, recursiveMethod, t});
-                    saved = true;
-                }
-                win.close();
-                return;
-            }
-        }
-
-        // play moves at interval
-        if (!finished && step < (int)moves.size()){
-            if (moveClock.getElapsedTime().asSeconds() > speed){
-                char f = moves[step].first;
-                char t = moves[step].second;
-                vector<int>* src = (f=='A'?&pegA:(f=='B'?&pegB:&pegC));
-                vector<int>* dst = (t=='A'?&pegA:(t=='B'?&pegB:&pegC));
-                if (!src->empty()){
-                    int id = src->back(); src->pop_back();
-                    placeDisk(disks[id], t, dst->size());
-                    dst->push_back(id);
-                }
-                ++step;
-                moveClock.restart();
+        // play the moves due since the last frame (rate * elapsed time)
+        double dt = moveClock.restart().asSeconds();
+        if (step < total){
+            finished = false;
+            if (!dragging) pending += dt * rate;
+            long long due = (long long)pending;
+            if (due > total - step) due = total - step;
+            bool skip = due > 4LL * n && closedForm; // jump over the frames in between
+            long long played = due;
+            if (producer){
+                // only what the generator has produced so far
+                played = producer->ring.consume((size_t)due, [&](const Move &m){ if (!skip) scene.applyMove(m); });
+                if (skip) jumpTo(step + played); else step += played;
             }
+            else if (skip) jumpTo(step + due);
+            else for (long long j = 0; j < due; ++j) scene.applyMove(moveAt(step++));
+            if (played < due) pending = 0; // generator behind: do not bank moves
+            else pending -= played;
         } else if (!finished){
             // finished now exactly when all moves applied
             finished = true;
             double finalT = timerClock.getElapsedTime().asSeconds();
-            timerText.setString("Final: " + formatDouble(finalT,6) + " s");
-            if (!saved){
-                history.push_back({n, recursiveMethod, finalT});
+            timerText.setString((seeked ? "Final (after seek): " : "Final: ") + formatDouble(finalT,6) + " s");
+            if (!saved && !seeked){
+                historyLog.append(n, recursiveMethod, finalT, genTime);
                 saved = true;
             }
         }
 
+        // generation time, measured on the producer thread without the waits on a full ring
+        if (producer && genTime < 0){
+            if (producer->finished()){
+                genTime = producer->genSeconds;
+                genText.setString("Generation: " + formatDouble(genTime,6) + " s (waited " +
+                                  formatDouble(producer->waitSeconds,3) + " s on the full buffer)");
+            } else if (step != shownStep)
+                genText.setString("Generating... " + to_string(producer->ring.size()) + " moves buffered");
+        }
+
+        // seek bar state (texts only rebuilt when they change)
+        float frac = total == 0 ? 1.f : (float)step / total;
+        seekFill.setSize(sf::Vector2f(barW * frac, 8));
+        seekHandle.setPosition(barX + barW * frac, barY + 4.f);
+        if (step != shownStep){
+            stepText.setString("Move " + to_string(step) + " / " + to_string(total));
+            shownStep = step;
+        }
+
+        // HUD: means of the last 60 frames, rebuilt every 15 frames
+        frameMoves = step - stepBefore;
+        if (showHud && frameCount++ % 15 == 0){
+            FrameTimes m = profiler.recent();
+            hudText.setString("frame " + formatDouble(m.total(),2) + " ms\nupdate " + formatDouble(m.update,3) +
+                              " ms\ndraw " + formatDouble(m.draw,3) + " ms\ndisplay " + formatDouble(m.display,2) +
+                              " ms (incl. 60 fps wait)\n" + to_string(m.moves) + " moves/frame\n" + hudStatus);
+        }
+
         // render
+        profiler.updated();
         win.clear(sf::Color::White);
-        win.draw(Arod); win.draw(Brod); win.draw(Crod);
-        for (auto &d : disks) win.draw(d);
+        scene.draw(win);
+
+        // seek bar + jump field
+        win.draw(seekTrack); win.draw(seekFill); win.draw(seekHandle);
+        win.draw(stepText); win.draw(jumpText);
 
-        // timer + back (capsule with text)
+        // timer, rate + back (capsule with text)
         win.draw(timerText);
-        drawCapsuleText(win, backRect, backRect.getFillColor(), font, "BACK TO MENU", 18);
+        win.draw(rateText);
+        win.draw(genText);
+        backButton.draw(win);
+        if (showHud) win.draw(hudText);
 
+        profiler.drawn();
         win.display();
+        profiler.displayed(frameMoves);
     }
 }
 
+/* ---------------- Offscreen benchmark ---------------- */
+// Plays the whole solution into a RenderTexture, no frame limit, movesPerFrame
+// moves per frame (needs an OpenGL context: Xvfb or Mesa software GL), after
+// timing the same generator alone. Returns the exit code.
+int runHeadlessBenchmark(int n, bool recursive, long long movesPerFrame, const string &csvPath, const sf::Font &font){
+    const long long total = (1LL << n) - 1;
+
+    // generation only: same generator, moves just counted
+    long long counted = 0;
+    auto counter = [&](char, char){ ++counted; };
+    auto g0 = chrono::steady_clock::now();
+    if (recursive) hanoiRec(n,'A','C','B',counter); else hanoiIter(n,'A','C','B',counter);
+    chrono::duration<double> genOnly = chrono::steady_clock::now() - g0;
+
+    sf::RenderTexture tex;
+    if (!tex.create(900,600)){
+        cerr << "Cannot create a render texture (no OpenGL context: run under Xvfb or with Mesa)\n";
+        return 1;
+    }
+    DiskScene scene(n);
+    sf::Text stepText("", font, 16);
+    stepText.setFillColor(sf::Color(60,60,70));
+    stepText.setPosition(100, 520);
+    FrameProfiler profiler(1 << 22);
+
+    // animation: same producer thread and ring as the window
+    auto a0 = chrono::steady_clock::now();
+    MoveProducer producer(n, recursive);
+    long long step = 0;
+    while (step < total){
+        profiler.begin();
+        long long want = min(movesPerFrame, total - step);
+        long long played = producer.ring.consume((size_t)want, [&](const Move &m){ scene.applyMove(m); });
+        step += played;
+        stepText.setString("Move " + to_string(step) + " / " + to_string(total));
+        profiler.updated();
+        tex.clear(sf::Color::White);
+        scene.draw(tex);
+        tex.draw(stepText);
+        profiler.drawn();
+        tex.display();
+        profiler.displayed(played);
+    }
+    chrono::duration<double> anim = chrono::steady_clock::now() - a0;
+    // the producer's timings are published by done, set after its last push
+    while (!producer.finished()) this_thread::yield();
+
+    size_t frames = profiler.frames().size() + profiler.droppedFrames();
+    cout << "Offscreen benchmark: n = " << n << ", " << (recursive ? "recursive" : "iterative") << ", "
+         << total << " moves (" << counted << " counted), " << movesPerFrame << " moves/frame\n";
+    cout << "Generation only : " << formatDouble(genOnly.count(),6) << " s\n";
+    cout << "Generation thread (during animation): " << formatDouble(producer.genSeconds,6) << " s busy, "
+         << formatDouble(producer.waitSeconds,6) << " s waiting on the full buffer\n";
+    cout << "Animation       : " << formatDouble(anim.count(),6) << " s, " << frames << " frames ("
+         << formatDouble(frames / anim.count(),1) << " fps)\n";
+    const char *names[3] = {"update", "draw", "display"};
+    double FrameTimes::*phases[3] = {&FrameTimes::update, &FrameTimes::draw, &FrameTimes::display};
+    for (int p = 0; p < 3; p++)
+        cout << "  " << setw(8) << left << names[p] << right << " mean " << formatDouble(profiler.mean(phases[p]),4)
+             << " ms  p50 " << formatDouble(profiler.percentile(phases[p], 0.5),4)
+             << " ms  p99 " << formatDouble(profiler.percentile(phases[p], 0.99),4) << " ms\n";
+    if (genOnly.count() > 0)
+        cout << "Rendering cost  : " << formatDouble(anim.count() - genOnly.count(),6) << " s ("
+             << formatDouble(anim.count() / genOnly.count(),1) << "x generation only)\n";
+    if (!csvPath.empty()){
+        if (!profiler.writeCsv(csvPath)) { cerr << "Cannot write " << csvPath << "\n"; return 1; }
+        cout << "Frame times written to " << csvPath << "\n";
+    }
+    return 0;
+}
+
 /* ---------------- main ---------------- */
-int main(){
+int main(int argc, char **argv){
     sf::Font font;
     if(!font.loadFromFile("Roboto-Regular.ttf")){
         // cannot render GUI without font; exit quietly
         return 1;
     }
 
+    // ./hanoi_gui --bench N [--iter] [--moves-per-frame K] [--csv FILE] : offscreen benchmark
+    // (K defaults to (2^N - 1) / BENCH_FRAMES, at least 1)
+    if (argc > 2 && string(argv[1]) == "--bench"){
+        int n = atoi(argv[2]);
+        bool recursive = true;
+        long long perFrame = 0; // default: about BENCH_FRAMES frames whatever n
+        string csv;
+        for (int i = 3; i < argc; ++i){
+            string a = argv[i];
+            if (a == "--iter") recursive = false;
+            else if (a == "--rec") recursive = true;
+            else if (a == "--moves-per-frame" && i + 1 < argc) perFrame = atoll(argv[++i]);
+            else if (a == "--csv" && i + 1 < argc) csv = argv[++i];
+            else { cerr << "Unknown option " << a << "\n"; return 1; }
+        }
+        if (perFrame == 0 && n >= 1 && n <= MAX_ANIM_DISKS) perFrame = max(1LL, ((1LL << n) - 1) / BENCH_FRAMES);
+        if (n < 1 || n > MAX_ANIM_DISKS || perFrame < 1){
+            cerr << "Usage: hanoi_gui --bench N (1.." << MAX_ANIM_DISKS << ") [--iter] [--moves-per-frame K] [--csv FILE]\n";
+            return 1;
+        }
+        return runHeadlessBenchmark(n, recursive, perFrame, csv, font);
+    }
+
+    // ./hanoi_gui FILE : replay a move file written by the console (--write / --solve ... --write)
+    if (argc > 1){
+        MoveFile file;
+        string error;
+        if (!file.open(argv[1], error)) { cerr << "Cannot read " << argv[1] << ": " << error << "\n"; return 1; }
+        if (file.disks() > MAX_ANIM_DISKS){
+            cerr << "The animation draws at most " << MAX_ANIM_DISKS << " disks (file has " << file.disks() << ")\n";
+            return 1;
+        }
+        if (!file.verify_checksum(1)) { cerr << "Checksum mismatch in " << argv[1] << "\n"; return 1; }
+        runAnimation(file.disks(), true, font, &file);
+        return 0;
+    }
+
+    string historyError;
+    if (!historyLog.open(HISTORY_FILE, historyError))
+        cerr << "History not saved (" << HISTORY_FILE << "): " << historyError << "\n";
+
     while (true){
-        MenuResult R = runMenu();
-        // always graphical; n limited to 8 in menu
+        MenuResult R = runMenu(font);
+        // always graphical; n limited to MAX_ANIM_DISKS in menu
         runAnimation(R.diskCount, R.recursive, font);
     }
 
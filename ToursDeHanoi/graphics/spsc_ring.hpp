@@ -0,0 +1,62 @@
+// spsc_ring.hpp — file circulaire sans verrou, un producteur / un consommateur
+// Capacité puissance de deux ; head (écrit par le consommateur) et tail
+// (écrit par le producteur) sont sur des lignes de cache séparées, et
+// chaque côté garde une copie de l'indice de l'autre pour ne relire
+// l'atomique partagé que lorsque la file semble pleine (ou vide).
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+template <class T>
+class SpscRing {
+public:
+    // capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity) {
+        size_t c = 1;
+        while (c < capacity) c <<= 1;
+        slots.resize(c);
+        mask = c - 1;
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    // Producer side; false when full
+    bool try_push(const T &v) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head_cache == capacity()) {
+            head_cache = head.load(std::memory_order_acquire);
+            if (t - head_cache == capacity()) return false;
+        }
+        slots[t & mask] = v;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: calls f(item) on up to max items, in order, straight
+    // from the slots, then releases them all at once; returns the count
+    template <class F>
+    size_t consume(size_t max, F f) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (tail_cache - h < max) tail_cache = tail.load(std::memory_order_acquire);
+        size_t n = tail_cache - h;
+        if (n > max) n = max;
+        for (size_t i = 0; i < n; i++) f(slots[(h + i) & mask]);
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    // Approximate from either side
+    size_t size() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+
+private:
+    std::vector<T> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> head{0};  // next slot to read
+    size_t tail_cache = 0;                    // consumer's view of tail
+    alignas(64) std::atomic<size_t> tail{0};  // next slot to write
+    size_t head_cache = 0;                    // producer's view of head
+};